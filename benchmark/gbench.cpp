@@ -1,8 +1,18 @@
 #include <benchmark/benchmark.h>
 // #include <rapidhttp/document.h>
 // #include <rapidhttp/doc.h>
+#include <rapidhttp/batch_parser.h>
+#include <rapidhttp/date_cache.h>
+#include <rapidhttp/dfa_engine.h>
+#include <rapidhttp/output_chain.h>
 #include <rapidhttp/parser.h>
+#include <rapidhttp/pull_parser.h>
+#include <rapidhttp/response_template.h>
+#include <rapidhttp/sax_parser.h>
 #include <stdio.h>
+
+#include <memory>
+#include <vector>
 #if PROFILE
 #include <gperftools/profiler.h>
 #endif
@@ -150,11 +160,119 @@ void BM_PartialParseResponse(benchmark::State &state) {
     }
 }
 
+// 头部每次只到达32字节, 数据累积在同一块接收缓冲区中, 没有消耗的部分下次再传入
+template <class DocType, bool Prescan>
+void BM_DribbleRequest(benchmark::State &state) {
+    const size_t segment = 32;
+    while (state.KeepRunning()) {
+        for (int x = 0; x < state.range(0); ++x) {
+            DocType doc(rapidhttp::HTTP_REQUEST);
+            doc.SetHeaderPrescan(Prescan);
+            size_t consumed = 0;
+            for (size_t end = segment; !doc.ParseDone() && !doc.ParseError(); end += segment) {
+                if (end > c_big_request.size()) end = c_big_request.size();
+                consumed += doc.PartailParse(c_big_request.data() + consumed, end - consumed);
+            }
+        }
+    }
+}
+
+// 64KB的上传, 每次recv最多16KB. 拷贝到连接缓冲区再解析到document, 或者在头部之后
+// 直接recv到预先分配的目标缓冲区(这里用memcpy模拟recv)
+static std::string MakeUpload() {
+    std::string body(64 * 1024, 'x');
+    return "POST /upload HTTP/1.1\r\nContent-Length: " + std::to_string(body.size()) +
+           "\r\n\r\n" + body;
+}
+static const std::string c_upload = MakeUpload();
+static const size_t c_recv_size = 16 * 1024;
+
+template <class DocType, bool Placed>
+void BM_Upload(benchmark::State &state) {
+    static char conn_buf[c_recv_size];
+    static char dest[64 * 1024];
+    while (state.KeepRunning()) {
+        for (int x = 0; x < state.range(0); ++x) {
+            DocType doc(rapidhttp::HTTP_REQUEST);
+            size_t pos = 0;
+            while (!doc.ParseDone() && !doc.ParseError()) {
+                size_t n = std::min(c_recv_size, c_upload.size() - pos);
+                if (Placed && doc.GetBodyDestination()) {
+                    n = std::min<size_t>(n, doc.ExpectedBytes());
+                    memcpy(dest + doc.BodyPlaced(), c_upload.data() + pos, n);
+                    pos += doc.CommitBody(n);
+                    continue;
+                }
+                memcpy(conn_buf, c_upload.data() + pos, n);
+                pos += doc.PartailParse(conn_buf, n);
+                if (Placed && doc.HeadersDone()) doc.SetBodyDestination(dest, sizeof(dest));
+            }
+            benchmark::DoNotOptimize(doc.ParseDone());
+        }
+    }
+}
+
+// 事件循环一次唤醒128个链接, 链接总数远大于cache, 每次唤醒的解析器和缓冲区都是冷的
+template <bool Batched>
+void BM_ParseConnections(benchmark::State &state) {
+    typedef rapidhttp::TParser<std::string> Parser;
+    const size_t c_conns = 16384, c_batch = 128;
+    static std::vector<std::unique_ptr<Parser>> parsers;
+    static std::vector<std::string> buffers;
+    static std::vector<size_t> order;
+    if (parsers.empty()) {
+        for (size_t i = 0; i < c_conns; ++i) {
+            parsers.emplace_back(new Parser(rapidhttp::HTTP_REQUEST));
+            buffers.push_back(c_http_request);
+            order.push_back(i * 7919 % c_conns);
+        }
+    }
+
+    std::vector<rapidhttp::TParseTask<Parser>> tasks(c_batch);
+    size_t next = 0;
+    while (state.KeepRunning()) {
+        for (size_t i = 0; i < c_batch; ++i, next = (next + 1) % c_conns) {
+            size_t conn = order[next];
+            tasks[i] = {parsers[conn].get(), buffers[conn].data(), buffers[conn].size(), 0};
+        }
+        if (Batched) {
+            rapidhttp::ParseBatch(tasks.data(), tasks.size());
+        } else {
+            for (auto &task : tasks) task.parsed = task.parser->PartailParse(task.data, task.len);
+        }
+        benchmark::DoNotOptimize(tasks.back().parsed);
+    }
+}
+
+template <typename DocType>
+DocType &GetResponseDoc() {
+    static DocType doc(rapidhttp::HTTP_RESPONSE);
+    if (!doc.IsInitialized()) {
+        doc.SetStatus(200, "OK");
+        doc.SetField("Accept", "XAccept");
+        doc.SetField("Host", "domain.com");
+        doc.SetField("Content-Length", "3");
+        doc.SetBody("abc");
+    }
+    return doc;
+}
+
+// 与GetResponseDoc内容相同, 已经PrepareCache
+template <typename DocType>
+DocType &GetCachedResponseDoc() {
+    static DocType doc = [] {
+        DocType cached = GetResponseDoc<DocType>();
+        cached.PrepareCache();
+        return cached;
+    }();
+    return doc;
+}
+
 template <class DocType>
 void BM_Serialize(benchmark::State &state) {
     while (state.KeepRunning()) {
         for (int x = 0; x < state.range(0); ++x) {
-            auto &doc = GetDoc<DocType>();
+            auto &doc = GetResponseDoc<DocType>();
             char buf[128] = {};
             bool b = doc.Serialize(buf, sizeof(buf));
             (void)b;
@@ -165,6 +283,218 @@ void BM_Serialize(benchmark::State &state) {
     }
 }
 
+// 与BM_Serialize相同, 但缓存命中: 只拷贝缓存的起始行/域和body
+template <class DocType>
+void BM_SerializeCached(benchmark::State &state) {
+    while (state.KeepRunning()) {
+        for (int x = 0; x < state.range(0); ++x) {
+            auto &doc = GetCachedResponseDoc<DocType>();
+            char buf[128] = {};
+            bool b = doc.Serialize(buf, sizeof(buf));
+            (void)b;
+        }
+    }
+}
+
+// 每次序列化前修改body, body不在缓存中, 缓存依然完整有效
+template <class DocType>
+void BM_SerializeDirtyBody(benchmark::State &state) {
+    while (state.KeepRunning()) {
+        for (int x = 0; x < state.range(0); ++x) {
+            auto &doc = GetCachedResponseDoc<DocType>();
+            doc.SetBody("xyz");
+            char buf[128] = {};
+            bool b = doc.Serialize(buf, sizeof(buf));
+            (void)b;
+        }
+    }
+}
+
+// 带Date域的response, 缓存命中时Date域在起始行和缓存的域之间单独写入
+template <class DocType>
+void BM_SerializeDate(benchmark::State &state) {
+    DocType doc = GetCachedResponseDoc<DocType>();
+    doc.SetDateField();
+    doc.PrepareCache();
+    while (state.KeepRunning()) {
+        for (int x = 0; x < state.range(0); ++x) {
+            char buf[256];
+            bool b = doc.Serialize(buf, sizeof(buf));
+            (void)b;
+        }
+    }
+}
+
+// 对照: 每个response都用strftime格式化Date
+void BM_DateStrftime(benchmark::State &state) {
+    while (state.KeepRunning()) {
+        for (int x = 0; x < state.range(0); ++x) {
+            char buf[64];
+            time_t now = time(nullptr);
+            struct tm tm;
+            gmtime_r(&now, &tm);
+            size_t n = strftime(buf, sizeof(buf), "Date: %a, %d %b %Y %H:%M:%S GMT\r\n", &tm);
+            benchmark::DoNotOptimize(n);
+        }
+    }
+}
+
+void BM_DateCache(benchmark::State &state) {
+    while (state.KeepRunning()) {
+        for (int x = 0; x < state.range(0); ++x) {
+            char buf[64];
+            benchmark::DoNotOptimize(rapidhttp::DateCache::Instance().Write(buf));
+        }
+    }
+}
+
+// 统计上报常见的长查询串: 几十个参数, 少量转义
+static std::string MakeBeaconQuery() {
+    std::string query;
+    for (int i = 0; query.size() < 3000; ++i) {
+        if (i) query += '&';
+        query += "param" + std::to_string(i) + "=some_value_" + std::to_string(i * 7919);
+        if (i % 8 == 0) query += "%2Fpath+with%20space";
+    }
+    return query;
+}
+
+void BM_PercentDecode(benchmark::State &state) {
+    std::string query = MakeBeaconQuery();
+    std::string out(query.size(), '\0');
+    while (state.KeepRunning()) {
+        size_t n = rapidhttp::PercentDecode(query.data(), query.size(), &out[0]);
+        benchmark::DoNotOptimize(n);
+    }
+    state.SetBytesProcessed(state.iterations() * query.size());
+}
+
+void BM_QueryParams(benchmark::State &state) {
+    std::string query = MakeBeaconQuery();
+    rapidhttp::QueryParams params(query.data(), query.size());
+    while (state.KeepRunning()) {
+        size_t n = 0;
+        for (auto const &param : params) n += param.value.size();
+        benchmark::DoNotOptimize(n);
+    }
+    state.SetBytesProcessed(state.iterations() * query.size());
+}
+
+// 从6KB的Cookie域中取出会话cookie
+void BM_FindCookie(benchmark::State &state) {
+    rapidhttp::Document doc(rapidhttp::HTTP_REQUEST);
+    std::string cookie;
+    for (int i = 0; cookie.size() < 6000; ++i)
+        cookie += "tracking_" + std::to_string(i) + "=" + std::string(40, 'x') + "; ";
+    cookie += "session=0123456789abcdef";
+    doc.SetField(std::string("Cookie"), cookie);
+    while (state.KeepRunning()) {
+        rapidhttp::StringRef value;
+        bool b = doc.FindCookie("session", &value);
+        benchmark::DoNotOptimize(b);
+    }
+    state.SetBytesProcessed(state.iterations() * cookie.size());
+}
+
+// 浏览器的Accept/Accept-Encoding
+void BM_Negotiate(benchmark::State &state) {
+    static const rapidhttp::MediaOffers media{"application/json", "text/html", "text/plain"};
+    static const rapidhttp::EncodingOffers encoding{"br", "gzip", "identity"};
+    std::string accept =
+        "text/html,application/xhtml+xml,application/xml;q=0.9,image/avif,image/webp,"
+        "image/apng,*/*;q=0.8,application/signed-exchange;v=b3;q=0.7";
+    std::string accept_encoding = "gzip, deflate, br, zstd";
+    while (state.KeepRunning()) {
+        int m = media.Negotiate(accept.data(), accept.size());
+        int e = encoding.Negotiate(accept_encoding.data(), accept_encoding.size());
+        benchmark::DoNotOptimize(m + e);
+    }
+}
+
+// 只保留少数几个域的解析器
+RAPIDHTTP_FIELD_SET(BenchFields, "Host", "Content-Length", "Authorization", "X-Request-Id");
+typedef rapidhttp::TParser<std::string, BenchFields> FieldSetParser;
+typedef rapidhttp::TParser<rapidhttp::StringRef, BenchFields> RefFieldSetParser;
+// 只解析request, 关闭upgrade/obs-fold/HTTP0.9
+typedef rapidhttp::TParser<rapidhttp::StringRef, rapidhttp::AllFields, rapidhttp::RequestFeatures>
+    RefRequestOnlyParser;
+
+typedef rapidhttp::TParser<std::string, rapidhttp::AllFields, rapidhttp::AllFeatures,
+                           rapidhttp::DfaEngine>
+    DfaParser;
+typedef rapidhttp::TParser<rapidhttp::StringRef, rapidhttp::AllFields, rapidhttp::AllFeatures,
+                           rapidhttp::DfaEngine>
+    RefDfaParser;
+
+// SAX解析: 只统计域的数量和body长度, 不生成document
+struct CountingHandler : rapidhttp::SaxHandler {
+    size_t fields = 0;
+    size_t body = 0;
+    void on_header(rapidhttp::StringRef const &, rapidhttp::StringRef const &) { ++fields; }
+    void on_body(const char *, size_t length) { body += length; }
+};
+typedef rapidhttp::TSaxParser<CountingHandler> CountingSaxParser;
+
+// 拉取式解析: 一次拉完全部token, 接口与callback解析器的测试用例一致
+struct DrainingPullParser : rapidhttp::PullParser {
+    explicit DrainingPullParser(rapidhttp::http_parser_type type) : PullParser(type) {}
+    size_t PartailParse(const char *buf, size_t len) {
+        Feed(buf, len);
+        size_t fields = 0;
+        for (;;) {
+            rapidhttp::PullToken const &token = Next();
+            if (token.type == rapidhttp::PullToken::kNeedMore) break;
+            if (token.type == rapidhttp::PullToken::kError) return 0;
+            fields += token.type == rapidhttp::PullToken::kHeader;
+        }
+        benchmark::DoNotOptimize(fields);
+        return len;
+    }
+    size_t PartailParse(std::string const &buf) { return PartailParse(buf.c_str(), buf.size()); }
+};
+
+static constexpr auto c_response_template = rapidhttp::MakeResponseTemplate(
+    RAPIDHTTP_STATUS_LINE(200, "OK") "Accept: XAccept\r\nHost: domain.com\r\nContent-Length: ",
+    "\r\n\r\n", "");
+
+// 与BM_Serialize输出相同的response, 由编译期模板生成
+void BM_SerializeTemplate(benchmark::State &state) {
+    std::string body = "abc";
+    while (state.KeepRunning()) {
+        for (int x = 0; x < state.range(0); ++x) {
+            char buf[128];
+            bool b = c_response_template.Serialize(buf, sizeof(buf), body.size(), body);
+            benchmark::DoNotOptimize(b);
+        }
+    }
+}
+
+// pipeline场景: 每个response各自SerializeAsString
+template <class DocType>
+void BM_SerializePipelinedString(benchmark::State &state) {
+    while (state.KeepRunning()) {
+        auto &doc = GetCachedResponseDoc<DocType>();
+        for (int x = 0; x < state.range(0); ++x) {
+            std::string s = doc.SerializeAsString();
+            benchmark::DoNotOptimize(s);
+        }
+    }
+}
+
+// pipeline场景: 全部追加到OutputChain, 一次ToIovec
+template <class DocType>
+void BM_SerializePipelinedChain(benchmark::State &state) {
+    rapidhttp::OutputChain chain(rapidhttp::OutputBlockPool::ThreadLocal());
+    struct iovec iov[16];
+    while (state.KeepRunning()) {
+        auto &doc = GetCachedResponseDoc<DocType>();
+        for (int x = 0; x < state.range(0); ++x) chain.Append(doc);
+        size_t n = chain.ToIovec(iov, 16);
+        benchmark::DoNotOptimize(n);
+        chain.Consume(chain.ByteSize());
+    }
+}
+
 template <class Src, class Dst>
 void BM_CopyTo(benchmark::State &state) {
     while (state.KeepRunning()) {
@@ -201,7 +531,50 @@ BENCHMARK_TEMPLATE(BM_ParseRequest_3_field, rapidhttp::TParser<std::string>)->Ar
 BENCHMARK_TEMPLATE(BM_ParseRequest_big, rapidhttp::TParser<std::string>)->Arg(1);
 BENCHMARK_TEMPLATE(BM_ParseResponse, rapidhttp::TParser<std::string>)->Arg(1);
 BENCHMARK_TEMPLATE(BM_PartialParseResponse, rapidhttp::TParser<std::string>)->Arg(1);
+BENCHMARK_TEMPLATE(BM_ParseRequest_0_field, DfaParser)->Arg(1);
+BENCHMARK_TEMPLATE(BM_ParseRequest_1_field, DfaParser)->Arg(1);
+BENCHMARK_TEMPLATE(BM_ParseRequest_2_field, DfaParser)->Arg(1);
+BENCHMARK_TEMPLATE(BM_ParseRequest_3_field, DfaParser)->Arg(1);
+BENCHMARK_TEMPLATE(BM_ParseRequest_big, DfaParser)->Arg(1);
+BENCHMARK_TEMPLATE(BM_ParseResponse, DfaParser)->Arg(1);
+BENCHMARK_TEMPLATE(BM_PartialParseResponse, DfaParser)->Arg(1);
+BENCHMARK_TEMPLATE(BM_DribbleRequest, rapidhttp::TParser<std::string>, false)->Arg(1);
+BENCHMARK_TEMPLATE(BM_DribbleRequest, rapidhttp::TParser<std::string>, true)->Arg(1);
+BENCHMARK_TEMPLATE(BM_Upload, rapidhttp::TParser<std::string>, false)->Arg(1);
+BENCHMARK_TEMPLATE(BM_Upload, rapidhttp::TParser<std::string>, true)->Arg(1);
+BENCHMARK_TEMPLATE(BM_ParseConnections, false);
+BENCHMARK_TEMPLATE(BM_ParseConnections, true);
+BENCHMARK_TEMPLATE(BM_ParseRequest_3_field, FieldSetParser)->Arg(1);
+BENCHMARK_TEMPLATE(BM_ParseRequest_big, FieldSetParser)->Arg(1);
 BENCHMARK_TEMPLATE(BM_Serialize, rapidhttp::Document)->Arg(1);
+BENCHMARK_TEMPLATE(BM_SerializeCached, rapidhttp::Document)->Arg(1);
+BENCHMARK_TEMPLATE(BM_SerializeDirtyBody, rapidhttp::Document)->Arg(1);
+BENCHMARK_TEMPLATE(BM_SerializePipelinedString, rapidhttp::Document)->Arg(16);
+BENCHMARK_TEMPLATE(BM_SerializePipelinedChain, rapidhttp::Document)->Arg(16);
+BENCHMARK(BM_SerializeTemplate)->Arg(1);
+BENCHMARK_TEMPLATE(BM_SerializeDate, rapidhttp::Document)->Arg(1);
+BENCHMARK(BM_DateStrftime)->Arg(1);
+BENCHMARK(BM_DateCache)->Arg(1);
+BENCHMARK(BM_PercentDecode);
+BENCHMARK(BM_QueryParams);
+BENCHMARK(BM_FindCookie);
+BENCHMARK(BM_Negotiate);
+
+BENCHMARK_TEMPLATE(BM_ParseRequest_0_field, CountingSaxParser)->Arg(1);
+BENCHMARK_TEMPLATE(BM_ParseRequest_1_field, CountingSaxParser)->Arg(1);
+BENCHMARK_TEMPLATE(BM_ParseRequest_2_field, CountingSaxParser)->Arg(1);
+BENCHMARK_TEMPLATE(BM_ParseRequest_3_field, CountingSaxParser)->Arg(1);
+BENCHMARK_TEMPLATE(BM_ParseRequest_big, CountingSaxParser)->Arg(1);
+BENCHMARK_TEMPLATE(BM_ParseResponse, CountingSaxParser)->Arg(1);
+BENCHMARK_TEMPLATE(BM_PartialParseResponse, CountingSaxParser)->Arg(1);
+
+BENCHMARK_TEMPLATE(BM_ParseRequest_0_field, DrainingPullParser)->Arg(1);
+BENCHMARK_TEMPLATE(BM_ParseRequest_1_field, DrainingPullParser)->Arg(1);
+BENCHMARK_TEMPLATE(BM_ParseRequest_2_field, DrainingPullParser)->Arg(1);
+BENCHMARK_TEMPLATE(BM_ParseRequest_3_field, DrainingPullParser)->Arg(1);
+BENCHMARK_TEMPLATE(BM_ParseRequest_big, DrainingPullParser)->Arg(1);
+BENCHMARK_TEMPLATE(BM_ParseResponse, DrainingPullParser)->Arg(1);
+BENCHMARK_TEMPLATE(BM_PartialParseResponse, DrainingPullParser)->Arg(1);
 
 BENCHMARK_TEMPLATE(BM_ParseRequest_0_field, rapidhttp::TParser<rapidhttp::StringRef>)->Arg(1);
 BENCHMARK_TEMPLATE(BM_ParseRequest_1_field, rapidhttp::TParser<rapidhttp::StringRef>)->Arg(1);
@@ -210,7 +583,38 @@ BENCHMARK_TEMPLATE(BM_ParseRequest_3_field, rapidhttp::TParser<rapidhttp::String
 BENCHMARK_TEMPLATE(BM_ParseRequest_big, rapidhttp::TParser<rapidhttp::StringRef>)->Arg(1);
 BENCHMARK_TEMPLATE(BM_ParseResponse, rapidhttp::TParser<rapidhttp::StringRef>)->Arg(1);
 BENCHMARK_TEMPLATE(BM_PartialParseResponse, rapidhttp::TParser<rapidhttp::StringRef>)->Arg(1);
+BENCHMARK_TEMPLATE(BM_ParseRequest_0_field, RefDfaParser)->Arg(1);
+BENCHMARK_TEMPLATE(BM_ParseRequest_1_field, RefDfaParser)->Arg(1);
+BENCHMARK_TEMPLATE(BM_ParseRequest_2_field, RefDfaParser)->Arg(1);
+BENCHMARK_TEMPLATE(BM_ParseRequest_3_field, RefDfaParser)->Arg(1);
+BENCHMARK_TEMPLATE(BM_ParseRequest_big, RefDfaParser)->Arg(1);
+BENCHMARK_TEMPLATE(BM_ParseResponse, RefDfaParser)->Arg(1);
+BENCHMARK_TEMPLATE(BM_PartialParseResponse, RefDfaParser)->Arg(1);
+BENCHMARK_TEMPLATE(BM_DribbleRequest, rapidhttp::TParser<rapidhttp::StringRef>, false)->Arg(1);
+BENCHMARK_TEMPLATE(BM_DribbleRequest, rapidhttp::TParser<rapidhttp::StringRef>, true)->Arg(1);
+BENCHMARK_TEMPLATE(BM_ParseRequest_3_field, RefFieldSetParser)->Arg(1);
+BENCHMARK_TEMPLATE(BM_ParseRequest_big, RefFieldSetParser)->Arg(1);
+BENCHMARK_TEMPLATE(BM_ParseRequest_0_field, RefRequestOnlyParser)->Arg(1);
+BENCHMARK_TEMPLATE(BM_ParseRequest_1_field, RefRequestOnlyParser)->Arg(1);
+BENCHMARK_TEMPLATE(BM_ParseRequest_2_field, RefRequestOnlyParser)->Arg(1);
+BENCHMARK_TEMPLATE(BM_ParseRequest_3_field, RefRequestOnlyParser)->Arg(1);
+BENCHMARK_TEMPLATE(BM_ParseRequest_big, RefRequestOnlyParser)->Arg(1);
 BENCHMARK_TEMPLATE(BM_Serialize, rapidhttp::TDocument<rapidhttp::StringRef>)->Arg(1);
+BENCHMARK_TEMPLATE(BM_SerializeCached, rapidhttp::TDocument<rapidhttp::StringRef>)->Arg(1);
+BENCHMARK_TEMPLATE(BM_SerializeDirtyBody, rapidhttp::TDocument<rapidhttp::StringRef>)->Arg(1);
+
+#if RAPIDHTTP_HAS_STRING_VIEW
+BENCHMARK_TEMPLATE(BM_ParseRequest_0_field, rapidhttp::TParser<std::string_view>)->Arg(1);
+BENCHMARK_TEMPLATE(BM_ParseRequest_1_field, rapidhttp::TParser<std::string_view>)->Arg(1);
+BENCHMARK_TEMPLATE(BM_ParseRequest_2_field, rapidhttp::TParser<std::string_view>)->Arg(1);
+BENCHMARK_TEMPLATE(BM_ParseRequest_3_field, rapidhttp::TParser<std::string_view>)->Arg(1);
+BENCHMARK_TEMPLATE(BM_ParseRequest_big, rapidhttp::TParser<std::string_view>)->Arg(1);
+BENCHMARK_TEMPLATE(BM_ParseResponse, rapidhttp::TParser<std::string_view>)->Arg(1);
+BENCHMARK_TEMPLATE(BM_PartialParseResponse, rapidhttp::TParser<std::string_view>)->Arg(1);
+BENCHMARK_TEMPLATE(BM_Serialize, rapidhttp::TDocument<std::string_view>)->Arg(1);
+BENCHMARK_TEMPLATE(BM_SerializeCached, rapidhttp::TDocument<std::string_view>)->Arg(1);
+BENCHMARK_TEMPLATE(BM_SerializeDirtyBody, rapidhttp::TDocument<std::string_view>)->Arg(1);
+#endif
 
 // BENCHMARK_TEMPLATE(BM_CopyTo, rapidhttp::HttpDocumentRef, rapidhttp::HttpDocument)->Arg(1);
 // BENCHMARK_TEMPLATE(BM_CopyTo, rapidhttp::HttpDocumentRef, rapidhttp::HttpDocumentRef)->Arg(1);
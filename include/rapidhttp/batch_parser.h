@@ -0,0 +1,46 @@
+#pragma once
+
+#include <stddef.h>
+
+#include "util.h"
+
+namespace rapidhttp {
+
+/// 批量解析中的一项: 一个链接的解析器和它新收到的数据
+template <typename Parser>
+struct TParseTask {
+    Parser* parser;
+    const char* data;
+    size_t len;
+    size_t parsed;  // 输出: PartailParse的返回值
+};
+
+/// 批量解析时每个链接预取的数据长度, 一般能覆盖请求行和前几个域
+static constexpr size_t c_batch_prefetch_bytes = 256;
+
+/// 批量解析多个链接
+// 事件循环一次唤醒大量链接时, 逐个解析会在每个链接的解析器状态和接收缓冲区上
+// 遇到cache miss. 这里按软件流水线的方式处理: 解析第i项的同时, 已经为第
+// i + distance项发出了解析器状态和数据开头的预取, 内存访问和解析重叠进行.
+// 每一项的结果和单独调用parser->PartailParse(data, len)相同, 按顺序解析,
+// 同一个解析器可以出现多次.
+// @Parser: 需要PartailParse(const char*, size_t)和Prefetch(), 比如TParser
+// @distance: 预取提前的项数, 解析一项的耗时越短需要越大
+template <typename Parser>
+inline void ParseBatch(TParseTask<Parser>* tasks, size_t n, size_t distance = 4) {
+    if (distance == 0) distance = 1;
+    for (size_t i = 0; i < n + distance; ++i) {
+        if (i < n) {
+            TParseTask<Parser>& next = tasks[i];
+            next.parser->Prefetch();
+            detail::Prefetch(next.data,
+                             next.len < c_batch_prefetch_bytes ? next.len : c_batch_prefetch_bytes);
+        }
+        if (i >= distance) {
+            TParseTask<Parser>& task = tasks[i - distance];
+            task.parsed = task.parser->PartailParse(task.data, task.len);
+        }
+    }
+}
+
+}  // namespace rapidhttp
@@ -0,0 +1,141 @@
+#pragma once
+
+#include <stddef.h>
+#include <string.h>
+
+#include <iterator>
+
+#include "stringref.h"
+#include "util.h"
+
+namespace rapidhttp {
+
+/// Cookie域中的一项, 指向域的值, 不发生拷贝
+struct Cookie {
+    StringRef name;
+    StringRef value;  // 去掉了两边的双引号
+};
+
+/// Cookie域的前向迭代器: "a=1; b=2; c=\"3\""
+// 按';'切分(memchr, libc按SIMD宽度扫描), 跳过空项. 没有'='的项按RFC 6265bis
+// 视为name为空.
+class CookieIterator {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = Cookie;
+    using difference_type = ptrdiff_t;
+    using pointer = const Cookie*;
+    using reference = const Cookie&;
+
+    CookieIterator() noexcept = default;
+    CookieIterator(const char* pos, const char* last) noexcept : pos_(pos), last_(last) { Next(); }
+
+    inline reference operator*() const noexcept { return cookie_; }
+    inline pointer operator->() const noexcept { return &cookie_; }
+    inline CookieIterator& operator++() noexcept {
+        Next();
+        return *this;
+    }
+    inline CookieIterator operator++(int) noexcept {
+        CookieIterator it = *this;
+        Next();
+        return it;
+    }
+    friend inline bool operator==(CookieIterator const& lhs, CookieIterator const& rhs) noexcept {
+        return lhs.current_ == rhs.current_;
+    }
+    friend inline bool operator!=(CookieIterator const& lhs, CookieIterator const& rhs) noexcept {
+        return !(lhs == rhs);
+    }
+
+  private:
+    inline void Next() noexcept {
+        while (pos_ < last_) {
+            const char* first = pos_;
+            const char* semi = (const char*)memchr(first, ';', last_ - first);
+            const char* end = semi ? semi : last_;
+            pos_ = semi ? semi + 1 : last_;
+
+            while (first < end && detail::IsOWS(*first)) ++first;
+            while (end > first && detail::IsOWS(end[-1])) --end;
+            if (first == end) continue;
+
+            const char* eq = (const char*)memchr(first, '=', end - first);
+            const char* value = eq ? eq + 1 : first;
+            if (eq) {
+                const char* name_end = eq;
+                while (name_end > first && detail::IsOWS(name_end[-1])) --name_end;
+                cookie_.name = StringRef(first, name_end - first);
+                while (value < end && detail::IsOWS(*value)) ++value;
+            } else {
+                cookie_.name = StringRef();
+            }
+            if (end - value >= 2 && *value == '"' && end[-1] == '"')
+                cookie_.value = StringRef(value + 1, end - value - 2);
+            else
+                cookie_.value = StringRef(value, end - value);
+            current_ = first;
+            return;
+        }
+        current_ = nullptr;
+    }
+
+  private:
+    const char* pos_{nullptr};
+    const char* last_{nullptr};
+    const char* current_{nullptr};  // 当前项的起始位置, 结束时为nullptr
+    Cookie cookie_;
+};
+
+/// 一个Cookie域的值上的cookie集合
+class CookieRange {
+  public:
+    CookieRange() noexcept = default;
+    CookieRange(const char* value, size_t len) noexcept : value_(value), len_(len) {}
+
+    inline CookieIterator begin() const noexcept { return CookieIterator(value_, value_ + len_); }
+    inline CookieIterator end() const noexcept { return CookieIterator(); }
+
+    /// 按名字查找第一个匹配的cookie, 不分配内存
+    // 直接用memmem在整个值里搜索名字, 再检查前后是否是项的边界,
+    // 不需要逐项切分, 几KB的Cookie域里取一两个cookie只扫描一遍.
+    inline bool Find(const char* name, size_t name_len, StringRef* value) const noexcept {
+        if (!name_len) return false;
+        const char* pos = value_;
+        const char* last = value_ + len_;
+        while (pos < last) {
+            const char* hit = (const char*)memmem(pos, last - pos, name, name_len);
+            if (!hit) return false;
+            pos = hit + 1;
+
+            const char* before = hit;
+            while (before > value_ && detail::IsOWS(before[-1])) --before;
+            if (before > value_ && before[-1] != ';') continue;
+            const char* after = hit + name_len;
+            while (after < last && detail::IsOWS(*after)) ++after;
+            if (after == last || *after != '=') continue;
+
+            const char* first = after + 1;
+            const char* end = (const char*)memchr(first, ';', last - first);
+            if (!end) end = last;
+            while (first < end && detail::IsOWS(*first)) ++first;
+            while (end > first && detail::IsOWS(end[-1])) --end;
+            if (end - first >= 2 && *first == '"' && end[-1] == '"') {
+                ++first;
+                --end;
+            }
+            *value = StringRef(first, end - first);
+            return true;
+        }
+        return false;
+    }
+    inline bool Find(const char* name, StringRef* value) const noexcept {
+        return Find(name, strlen(name), value);
+    }
+
+  private:
+    const char* value_{nullptr};
+    size_t len_{0};
+};
+
+}  // namespace rapidhttp
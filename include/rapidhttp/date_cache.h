@@ -0,0 +1,140 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+#include <atomic>
+
+namespace rapidhttp {
+
+/// 预渲染的Date域: "Date: Sun, 06 Nov 1994 08:49:37 GMT\r\n" (RFC 7231 IMF-fixdate)
+// 全进程共享一份, 每秒最多格式化一次. 读取方不加锁: 共享的那份用seqlock发布,
+// 每个线程再持有一份快照, 同一秒内的读取只比较一次秒数.
+class DateCache {
+  public:
+    static const size_t c_line_size = 37;
+
+    static DateCache& Instance() {
+        static DateCache cache;
+        return cache;
+    }
+
+    /// 当前秒数, 优先使用低开销的粗粒度时钟
+    static inline int64_t Now() noexcept {
+#ifdef CLOCK_REALTIME_COARSE
+        struct timespec ts;
+        if (clock_gettime(CLOCK_REALTIME_COARSE, &ts) == 0) return ts.tv_sec;
+#endif
+        return (int64_t)time(nullptr);
+    }
+
+    /// 格式化时间t对应的Date域, buf至少c_line_size字节
+    static inline char* Format(int64_t t, char* buf) noexcept {
+        static const char c_week[] = "SunMonTueWedThuFriSat";
+        static const char c_month[] = "JanFebMarAprMayJunJulAugSepOctNovDec";
+
+        time_t tt = (time_t)t;
+        struct tm tm;
+        gmtime_r(&tt, &tm);
+
+#define _WRITE_2DIGITS(v)         \
+    *buf++ = (v) / 10 % 10 + '0'; \
+    *buf++ = (v) % 10 + '0'
+
+        memcpy(buf, "Date: ", 6);
+        buf += 6;
+        memcpy(buf, c_week + tm.tm_wday * 3, 3);
+        buf += 3;
+        *buf++ = ',';
+        *buf++ = ' ';
+        _WRITE_2DIGITS(tm.tm_mday);
+        *buf++ = ' ';
+        memcpy(buf, c_month + tm.tm_mon * 3, 3);
+        buf += 3;
+        *buf++ = ' ';
+        _WRITE_2DIGITS((tm.tm_year + 1900) / 100);
+        _WRITE_2DIGITS(tm.tm_year + 1900);
+        *buf++ = ' ';
+        _WRITE_2DIGITS(tm.tm_hour);
+        *buf++ = ':';
+        _WRITE_2DIGITS(tm.tm_min);
+        *buf++ = ':';
+        _WRITE_2DIGITS(tm.tm_sec);
+        memcpy(buf, " GMT\r\n", 6);
+        return buf + 6;
+
+#undef _WRITE_2DIGITS
+    }
+
+    /// 当前的Date域, 指向调用线程的快照, 内容在下一秒读取时被刷新
+    inline const char* Line() noexcept { return Line(Now()); }
+    inline const char* Line(int64_t now) noexcept {
+        Snapshot& snapshot = ThreadSnapshot();
+        if (snapshot.sec != now) Load(now, snapshot);
+        return snapshot.line;
+    }
+
+    /// 把当前的Date域写入buf
+    inline char* Write(char* buf) noexcept {
+        memcpy(buf, Line(), c_line_size);
+        return buf + c_line_size;
+    }
+
+  private:
+    static const size_t c_words = (c_line_size + 7) / 8;
+
+    struct Snapshot {
+        int64_t sec{-1};
+        char line[c_words * 8]{};
+    };
+
+    static inline Snapshot& ThreadSnapshot() noexcept {
+        static thread_local Snapshot snapshot;
+        return snapshot;
+    }
+
+    DateCache() noexcept = default;
+
+    // 先尝试从共享的那份拷贝, 过期或正在被改写时自己格式化, 并尝试发布出去
+    inline void Load(int64_t now, Snapshot& snapshot) noexcept {
+        uint64_t seq = seq_.load(std::memory_order_acquire);
+        if (!(seq & 1) && sec_.load(std::memory_order_relaxed) == now) {
+            uint64_t words[c_words];
+            for (size_t i = 0; i < c_words; ++i) words[i] = words_[i].load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (seq_.load(std::memory_order_relaxed) == seq) {
+                memcpy(snapshot.line, words, sizeof(words));
+                snapshot.sec = now;
+                return;
+            }
+        }
+
+        Format(now, snapshot.line);
+        snapshot.sec = now;
+        Publish(now, snapshot.line);
+    }
+
+    inline void Publish(int64_t now, const char* line) noexcept {
+        uint64_t seq = seq_.load(std::memory_order_relaxed);
+        // 只允许一个写入者, 抢不到就放弃, 下次读取的线程会再试
+        if ((seq & 1) || sec_.load(std::memory_order_relaxed) >= now ||
+            !seq_.compare_exchange_strong(seq, seq + 1, std::memory_order_acquire))
+            return;
+        std::atomic_thread_fence(std::memory_order_release);
+
+        uint64_t words[c_words];
+        memcpy(words, line, sizeof(words));
+        for (size_t i = 0; i < c_words; ++i) words_[i].store(words[i], std::memory_order_relaxed);
+        sec_.store(now, std::memory_order_relaxed);
+        seq_.store(seq + 2, std::memory_order_release);
+    }
+
+  private:
+    std::atomic<uint64_t> seq_{0};
+    std::atomic<int64_t> sec_{-1};
+    std::atomic<uint64_t> words_[c_words]{};
+};
+
+}  // namespace rapidhttp
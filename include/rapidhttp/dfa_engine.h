@@ -0,0 +1,783 @@
+#pragma once
+
+#include <limits.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+
+#include "layer.hpp"
+#include "lookup_tables.h"
+#include "util.h"
+
+namespace rapidhttp {
+
+namespace dfa {
+/// 字符类
+enum eCharClass : uint8_t {
+    kClassCtl,    // 控制字符和DEL
+    kClassSp,     // ' '
+    kClassHt,     // '\t'
+    kClassCr,     // '\r'
+    kClassLf,     // '\n'
+    kClassColon,  // ':'
+    kClassDigit,  // 0-9
+    kClassHex,    // a-f A-F
+    kClassH,      // 'H'
+    kClassT,      // 'T'
+    kClassP,      // 'P'
+    kClassSlash,  // '/'
+    kClassDot,    // '.'
+    kClassTchar,  // 其他token字符(RFC 7230 tchar)
+    kClassVchar,  // 其他可见字符
+    kClassObs,    // 0x80-0xff
+    kClassCount,
+};
+static_assert(kClassCount == 16, "transition rows are indexed with state * 16 + class");
+
+/// 状态, 有动作的状态只在状态切换时处理, 停留在原状态的字节只查表
+enum eState : uint8_t {
+    kDead,
+    // request line
+    kReqStart,
+    kMethod,  // span
+    kUrlStart,
+    kUrl,  // span
+    kReqVersion,
+    kReqH,
+    kReqHT,
+    kReqHTT,
+    kReqHTTP,
+    kReqSlash,
+    kReqMajor,
+    kReqDot,
+    kReqMinor,
+    // status line
+    kResStart,
+    kResH,
+    kResHT,
+    kResHTT,
+    kResHTTP,
+    kResSlash,
+    kResMajor,
+    kResDot,
+    kResMinor,
+    kStatusStart,
+    kStatusCode,  // span
+    kReasonStart,
+    kReason,  // span
+    kLineAlmostDone,
+    // headers
+    kFieldStart,
+    kField,  // span
+    kValueStart,
+    kValue,  // span
+    kValueAlmostDone,
+    kHeadersAlmostDone,
+    kHeadersDone,  // 虚拟状态, 进入时决定body的读法
+    // chunked body
+    kChunkSizeStart,
+    kChunkSize,  // span
+    kChunkExt,
+    kChunkSizeAlmostDone,
+    kChunkData,  // 整块交给on_body, 不逐字节查表
+    kChunkDataCr,
+    kChunkDataLf,
+    // 其他body, 整块交给on_body
+    kBodyIdentity,
+    kBodyEof,
+    kStateCount,
+};
+
+constexpr uint8_t ClassOf(size_t ch) {
+    return ch == ' '                          ? kClassSp
+           : ch == '\t'                       ? kClassHt
+           : ch == '\r'                       ? kClassCr
+           : ch == '\n'                       ? kClassLf
+           : ch < 0x20 || ch == 0x7f          ? kClassCtl
+           : ch >= 0x80                       ? kClassObs
+           : ch == ':'                        ? kClassColon
+           : ch >= '0' && ch <= '9'           ? kClassDigit
+           : (ch >= 'a' && ch <= 'f') || (ch >= 'A' && ch <= 'F') ? kClassHex
+           : ch == 'H'                        ? kClassH
+           : ch == 'T'                        ? kClassT
+           : ch == 'P'                        ? kClassP
+           : ch == '/'                        ? kClassSlash
+           : ch == '.'                        ? kClassDot
+           : (ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z') ||
+                   ch == '!' || ch == '#' || ch == '$' || ch == '%' || ch == '&' ||
+                   ch == '\'' || ch == '*' || ch == '+' || ch == '-' || ch == '^' ||
+                   ch == '_' || ch == '`' || ch == '|' || ch == '~'
+               ? kClassTchar
+               : kClassVchar;
+}
+
+constexpr bool IsTchar(uint8_t c) {
+    return c == kClassDigit || c == kClassHex || c == kClassH || c == kClassT || c == kClassP ||
+           c == kClassDot || c == kClassTchar;
+}
+constexpr bool IsVisible(uint8_t c) {
+    return IsTchar(c) || c == kClassColon || c == kClassSlash || c == kClassVchar;
+}
+// uri中允许的字符, 和http-parser的严格模式一样不接受0x80以上的字节.
+// uri的形式(以'/'或'*'开始, 或者scheme://host)在span结束时用parse_url_char检查
+constexpr bool IsUrl(uint8_t c) { return IsVisible(c); }
+// 域值和原因短语中允许的字符, 包括obs-text
+constexpr bool IsText(uint8_t c) {
+    return IsVisible(c) || c == kClassObs || c == kClassSp || c == kClassHt;
+}
+constexpr bool IsHex(uint8_t c) { return c == kClassDigit || c == kClassHex; }
+constexpr bool IsLineEnd(uint8_t c) { return c == kClassCr || c == kClassLf; }
+
+// 只依赖字符类的状态转移, 值和长度相关的判断(method, 状态码, Content-Length等)
+// 在span结束时处理
+constexpr uint8_t NextState(uint8_t s, uint8_t c) {
+    return s == kReqStart    ? (IsLineEnd(c) ? kReqStart : IsTchar(c) ? kMethod : kDead)
+           : s == kMethod    ? (IsTchar(c) ? kMethod : c == kClassSp ? kUrlStart : kDead)
+           : s == kUrlStart  ? (c == kClassSp ? kUrlStart : IsUrl(c) ? kUrl : kDead)
+           : s == kUrl       ? (IsUrl(c) ? kUrl : c == kClassSp ? kReqVersion : kDead)
+           : s == kReqVersion ? (c == kClassSp ? kReqVersion : c == kClassH ? kReqH : kDead)
+           : s == kReqH      ? (c == kClassT ? kReqHT : kDead)
+           : s == kReqHT     ? (c == kClassT ? kReqHTT : kDead)
+           : s == kReqHTT    ? (c == kClassP ? kReqHTTP : kDead)
+           : s == kReqHTTP   ? (c == kClassSlash ? kReqSlash : kDead)
+           : s == kReqSlash  ? (c == kClassDigit ? kReqMajor : kDead)
+           : s == kReqMajor  ? (c == kClassDot ? kReqDot : kDead)
+           : s == kReqDot    ? (c == kClassDigit ? kReqMinor : kDead)
+           : s == kReqMinor  ? (c == kClassCr   ? kLineAlmostDone
+                                : c == kClassLf ? kFieldStart
+                                                : kDead)
+           : s == kResStart  ? (IsLineEnd(c) ? kResStart : c == kClassH ? kResH : kDead)
+           : s == kResH      ? (c == kClassT ? kResHT : kDead)
+           : s == kResHT     ? (c == kClassT ? kResHTT : kDead)
+           : s == kResHTT    ? (c == kClassP ? kResHTTP : kDead)
+           : s == kResHTTP   ? (c == kClassSlash ? kResSlash : kDead)
+           : s == kResSlash  ? (c == kClassDigit ? kResMajor : kDead)
+           : s == kResMajor  ? (c == kClassDot ? kResDot : kDead)
+           : s == kResDot    ? (c == kClassDigit ? kResMinor : kDead)
+           : s == kResMinor  ? (c == kClassSp ? kStatusStart : kDead)
+           : s == kStatusStart ? (c == kClassSp      ? kStatusStart
+                                  : c == kClassDigit ? kStatusCode
+                                                     : kDead)
+           : s == kStatusCode ? (c == kClassDigit ? kStatusCode
+                                 : c == kClassSp  ? kReasonStart
+                                 : c == kClassCr  ? kLineAlmostDone
+                                 : c == kClassLf  ? kFieldStart
+                                                  : kDead)
+           : s == kReasonStart ? (c == kClassSp || c == kClassHt ? kReasonStart
+                                  : c == kClassCr                ? kLineAlmostDone
+                                  : c == kClassLf                ? kFieldStart
+                                  : IsText(c)                    ? kReason
+                                                                 : kDead)
+           : s == kReason    ? (IsText(c)         ? kReason
+                                : c == kClassCr ? kLineAlmostDone
+                                : c == kClassLf ? kFieldStart
+                                                : kDead)
+           : s == kLineAlmostDone ? (c == kClassLf ? kFieldStart : kDead)
+           // 以空白开始的域是obs-fold, 不支持
+           : s == kFieldStart ? (c == kClassCr   ? kHeadersAlmostDone
+                                 : c == kClassLf ? kHeadersDone
+                                 : IsTchar(c)    ? kField
+                                                 : kDead)
+           : s == kField     ? (IsTchar(c) ? kField : c == kClassColon ? kValueStart : kDead)
+           : s == kValueStart ? (c == kClassSp || c == kClassHt ? kValueStart
+                                 : c == kClassCr                ? kValueAlmostDone
+                                 : c == kClassLf                ? kFieldStart
+                                 : IsText(c)                    ? kValue
+                                                                : kDead)
+           : s == kValue     ? (IsText(c)         ? kValue
+                                : c == kClassCr ? kValueAlmostDone
+                                : c == kClassLf ? kFieldStart
+                                                : kDead)
+           : s == kValueAlmostDone ? (c == kClassLf ? kFieldStart : kDead)
+           : s == kHeadersAlmostDone ? (c == kClassLf ? kHeadersDone : kDead)
+           : s == kChunkSizeStart ? (IsHex(c) ? kChunkSize : kDead)
+           // chunk扩展只能以';'或' '开始, 进入kChunkExt时检查是哪个字符
+           : s == kChunkSize ? (IsHex(c)        ? kChunkSize
+                                : c == kClassCr ? kChunkSizeAlmostDone
+                                : c == kClassSp || c == kClassVchar ? kChunkExt
+                                                                    : kDead)
+           : s == kChunkExt  ? (c == kClassCr ? kChunkSizeAlmostDone
+                                : IsLineEnd(c) || c == kClassCtl ? kDead
+                                                                 : kChunkExt)
+           : s == kChunkSizeAlmostDone ? (c == kClassLf ? kChunkData : kDead)
+           : s == kChunkDataCr ? (c == kClassCr ? kChunkDataLf : kDead)
+           : s == kChunkDataLf ? (c == kClassLf ? kChunkSizeStart : kDead)
+                               : kDead;
+}
+
+// 在某个状态下遇到非法字符时的错误码
+constexpr uint8_t ErrorOf(size_t s) {
+    return s <= kMethod                     ? HPE_INVALID_METHOD
+           : s <= kUrl                      ? HPE_INVALID_URL
+           : s <= kReqMinor                 ? HPE_INVALID_VERSION
+           : s <= kResStart                 ? HPE_INVALID_CONSTANT
+           : s <= kResMinor                 ? HPE_INVALID_VERSION
+           : s <= kReason                   ? HPE_INVALID_STATUS
+           : s == kLineAlmostDone           ? HPE_LF_EXPECTED
+           : s <= kValue                    ? HPE_INVALID_HEADER_TOKEN
+           : s <= kHeadersDone              ? HPE_LF_EXPECTED
+           : s <= kChunkSizeAlmostDone      ? HPE_INVALID_CHUNK_SIZE
+                                            : HPE_STRICT;
+}
+
+template <typename Seq>
+struct ClassTable;
+template <size_t... I>
+struct ClassTable<detail::IndexSequence<I...>> {
+    alignas(64) static constexpr uint8_t values[sizeof...(I)] = {ClassOf(I)...};
+};
+template <size_t... I>
+alignas(64) constexpr uint8_t ClassTable<detail::IndexSequence<I...>>::values[sizeof...(I)];
+
+template <typename Seq>
+struct TransitionTable;
+template <size_t... I>
+struct TransitionTable<detail::IndexSequence<I...>> {
+    // 下标: state * kClassCount + class
+    alignas(64) static constexpr uint8_t next[sizeof...(I)] = {
+        NextState(I / kClassCount, I % kClassCount)...};
+};
+template <size_t... I>
+alignas(64) constexpr uint8_t TransitionTable<detail::IndexSequence<I...>>::next[sizeof...(I)];
+
+template <typename Seq>
+struct ErrorTable;
+template <size_t... I>
+struct ErrorTable<detail::IndexSequence<I...>> {
+    static constexpr uint8_t values[sizeof...(I)] = {ErrorOf(I)...};
+};
+template <size_t... I>
+constexpr uint8_t ErrorTable<detail::IndexSequence<I...>>::values[sizeof...(I)];
+
+using ClassTableType = ClassTable<detail::MakeIndexSequence<256>::type>;
+using TransitionTableType =
+    TransitionTable<detail::MakeIndexSequence<kStateCount * kClassCount>::type>;
+using ErrorTableType = ErrorTable<detail::MakeIndexSequence<kStateCount>::type>;
+
+// 需要特殊处理值的域
+enum eSpecialField : uint8_t {
+    kFieldOther,
+    kFieldContentLength,
+    kFieldTransferEncoding,
+    kFieldConnection,
+    kFieldUpgrade,
+};
+
+inline uint8_t SpecialFieldOf(const char* name, size_t len) noexcept {
+    switch (len) {
+        case 7:
+            return EqualsNoCase(name, len, "upgrade", 7) ? kFieldUpgrade : kFieldOther;
+        case 10:
+            return EqualsNoCase(name, len, "connection", 10) ? kFieldConnection : kFieldOther;
+        case 14:
+            return EqualsNoCase(name, len, "content-length", 14) ? kFieldContentLength
+                                                                   : kFieldOther;
+        case 16:
+            return EqualsNoCase(name, len, "proxy-connection", 16) ? kFieldConnection
+                                                                     : kFieldOther;
+        case 17:
+            return EqualsNoCase(name, len, "transfer-encoding", 17) ? kFieldTransferEncoding
+                                                                      : kFieldOther;
+        default:
+            return kFieldOther;
+    }
+}
+}  // namespace dfa
+
+/// 表驱动的解析引擎
+// 字符类和状态转移在编译期生成为按cache line对齐的表, 热循环里每个字节只是两次查表,
+// 只有状态切换(一个span的开始或结束)时才执行动作; body整块交给on_body.
+// uri在span结束时再用http-parser的parse_url_char检查一遍形式.
+// 与http_parser_execute使用同一套http_parser/http_parser_settings, 回调语义相同,
+// trailer也和http-parser一样通过on_header_field/on_header_value回调.
+// 作为TParser的Engine模板参数使用:
+//
+//   rapidhttp::TParser<std::string, rapidhttp::AllFields, rapidhttp::AllFeatures,
+//                      rapidhttp::DfaEngine> parser(rapidhttp::HTTP_REQUEST);
+//
+// 与http-parser严格模式的全部差异:
+//   - 不支持HTTP/0.9(没有版本号的请求行)和obs-fold, 按非法字符处理
+//   - 不支持http_parser_pause, 回调返回非0时直接结束解析
+//   - chunk扩展中的控制字符和裸LF报错, http-parser忽略CR之前的所有字节
+//   - lenient_http_headers只放宽Transfer-Encoding和Content-Length同时出现的检查,
+//     不放宽域值中的字符
+//   - 出错时返回的字节数和错误码不保证相同: 状态码超过999在状态码结束时才报错,
+//     chunk大小溢出报HPE_INVALID_CHUNK_SIZE, 被缓冲区切断的uri出错时返回整个缓冲区的长度
+class DfaEngine {
+  public:
+    inline void Init(http_parser* parser, http_parser_type type) {
+        http_parser_init(parser, type);
+        state_ = type == HTTP_RESPONSE ? dfa::kResStart : dfa::kReqStart;
+        StartMessage(parser);
+    }
+
+    inline size_t Execute(http_parser* parser, const http_parser_settings* settings,
+                          const char* data, size_t len);
+
+    /// 见TParser::ExpectedBytes
+    inline uint64_t ExpectedBytes(const http_parser* parser) const noexcept {
+        using namespace dfa;
+        switch (state_) {
+            case kBodyIdentity:
+                return parser->content_length;
+            case kChunkData:
+                return parser->content_length + 2 + 5;
+            case kChunkDataCr:
+                return 2 + 5;
+            case kChunkDataLf:
+                return 1 + 5;
+            default:
+                return 1;
+        }
+    }
+
+  private:
+    inline void StartMessage(http_parser* parser) {
+        parser->flags = 0;
+        parser->uses_transfer_encoding = 0;
+        parser->content_length = ULLONG_MAX;
+        field_ = dfa::kFieldOther;
+        header_bytes_ = 0;
+        token_.clear();
+    }
+
+    static inline bool Fail(http_parser* parser, enum http_errno err) noexcept {
+        parser->http_errno = err;
+        return false;
+    }
+    static inline bool Notify(http_parser* parser, http_cb cb, enum http_errno err) {
+        if (cb && cb(parser) != 0) return Fail(parser, err);
+        return HTTP_PARSER_ERRNO(parser) == HPE_OK;
+    }
+    static inline bool Data(http_parser* parser, http_data_cb cb, enum http_errno err,
+                            const char* at, size_t length) {
+        if (cb && cb(parser, at, length) != 0) return Fail(parser, err);
+        return HTTP_PARSER_ERRNO(parser) == HPE_OK;
+    }
+
+    // span结束: 被缓冲区切断的span拼接在token_中
+    inline bool EndSpan(http_parser* parser, const http_parser_settings* settings, uint8_t state,
+                        const char* mark, const char* p);
+    // 缓冲区结束时还在span中
+    inline bool SuspendSpan(http_parser* parser, const http_parser_settings* settings,
+                            uint8_t state, const char* mark, const char* end);
+    inline bool OnValue(http_parser* parser, const char* s, size_t len);
+    // 按http-parser的规则检查uri的一段, 出错时*end指向非法字符
+    inline bool ScanUrl(http_parser* parser, const char* s, const char** end);
+    // @returns: 下一个状态, kDead表示出错, kStateCount表示upgrade之后停止解析
+    inline uint8_t HeadersDone(http_parser* parser, const http_parser_settings* settings);
+    inline bool MessageDone(http_parser* parser, const http_parser_settings* settings);
+    inline const char* Body(http_parser* parser, const http_parser_settings* settings,
+                            const char* p, const char* end);
+
+  private:
+    uint8_t state_{dfa::kReqStart};
+    uint8_t field_{dfa::kFieldOther};  // 当前域是不是需要处理值的域
+    uint8_t url_state_{s_dead};        // parse_url_char的状态
+    uint32_t header_bytes_{0};
+    std::string token_;
+};
+
+inline size_t DfaEngine::Execute(http_parser* parser, const http_parser_settings* settings,
+                                 const char* data, size_t len) {
+    using namespace dfa;
+    if (HTTP_PARSER_ERRNO(parser) != HPE_OK) return 0;
+
+    if (len == 0) {
+        if (state_ == kBodyEof) {
+            MessageDone(parser, settings);
+        } else if (state_ != kReqStart && state_ != kResStart) {
+            Fail(parser, HPE_INVALID_EOF_STATE);
+        }
+        return 0;
+    }
+
+    const uint8_t* classes = ClassTableType::values;
+    const uint8_t* next_states = TransitionTableType::next;
+    const char* p = data;
+    const char* end = data + len;
+    const char* mark = data;        // 当前span的开始, 从上次切断的地方继续
+    const char* head_begin = data;  // 当前消息的头部在本缓冲区中的开始
+    uint8_t state = state_;
+
+    if (state >= kBodyIdentity || state == kChunkData) {
+        p = Body(parser, settings, p, end);
+        if (!p) return 0;
+        state = state_;
+        head_begin = p;
+    }
+
+    while (p < end) {
+        uint8_t next = next_states[state * kClassCount + classes[(uint8_t)*p]];
+        if (LIKELY(next == state)) {
+            ++p;
+            continue;
+        }
+
+        // 离开原状态
+        switch (state) {
+            case kUrl:
+                if (!ScanUrl(parser, mark, &p) || !EndSpan(parser, settings, state, mark, p))
+                    return p - data;
+                break;
+            case kMethod:
+            case kStatusCode:
+            case kReason:
+            case kField:
+            case kValue:
+            case kChunkSize:
+                if (!EndSpan(parser, settings, state, mark, p)) return p - data;
+                break;
+            case kValueStart:
+                // 空的值
+                if (next != kValue) {
+                    if (!Data(parser, settings->on_header_value, HPE_CB_header_value, p, 0) ||
+                        !OnValue(parser, p, 0))
+                        return p - data;
+                }
+                break;
+            case kReqStart:
+            case kResStart:
+                StartMessage(parser);
+                head_begin = p;
+                break;
+        }
+
+        // 进入新状态
+        switch (next) {
+            case kDead:
+                Fail(parser, (enum http_errno)ErrorTableType::values[state]);
+                return p - data;
+            case kUrl:
+                url_state_ = parser->method == HTTP_CONNECT ? s_req_server_start
+                                                            : s_req_spaces_before_url;
+                mark = p;
+                break;
+            case kMethod:
+            case kStatusCode:
+            case kReason:
+            case kField:
+            case kValue:
+            case kChunkSize:
+                mark = p;
+                break;
+            case kChunkExt:
+                if (*p != ';' && *p != ' ') {
+                    Fail(parser, HPE_INVALID_CHUNK_SIZE);
+                    return p - data;
+                }
+                break;
+            case kReqMajor:
+            case kResMajor:
+                parser->http_major = *p - '0';
+                break;
+            case kReqMinor:
+            case kResMinor:
+                parser->http_minor = *p - '0';
+                break;
+            case kHeadersDone:
+                header_bytes_ += (uint32_t)(p + 1 - head_begin);
+                if (header_bytes_ > HTTP_MAX_HEADER_SIZE) {
+                    Fail(parser, HPE_HEADER_OVERFLOW);
+                    return p - data;
+                }
+                next = HeadersDone(parser, settings);
+                if (next == kDead) return p - data;
+                // upgrade之后的数据属于另一个协议
+                if (next == kStateCount) {
+                    state_ = parser->type == HTTP_RESPONSE ? kResStart : kReqStart;
+                    return p + 1 - data;
+                }
+                break;
+            case kChunkData:
+                if (!Notify(parser, settings->on_chunk_header, HPE_CB_chunk_header))
+                    return p + 1 - data;
+                // 最后一个chunk, 之后的trailer按头部的域解析, 到空行时在HeadersDone中结束
+                if (parser->content_length == 0) {
+                    parser->flags |= F_TRAILING;
+                    next = kFieldStart;
+                    header_bytes_ = 0;
+                    head_begin = p + 1;
+                }
+                break;
+            case kChunkSizeStart:
+                if (!Notify(parser, settings->on_chunk_complete, HPE_CB_chunk_complete))
+                    return p + 1 - data;
+                break;
+        }
+        ++p;
+        state = next;
+
+        if (state >= kBodyIdentity || state == kChunkData) {
+            state_ = state;
+            const char* body_end = Body(parser, settings, p, end);
+            if (!body_end) return p - data;
+            p = body_end;
+            state = state_;
+            head_begin = p;
+        } else if (state == kReqStart || state == kResStart) {
+            head_begin = p;
+        }
+    }
+
+    if (state < kChunkSizeStart && state != kReqStart && state != kResStart) {
+        header_bytes_ += (uint32_t)(end - head_begin);
+        if (header_bytes_ > HTTP_MAX_HEADER_SIZE) {
+            Fail(parser, HPE_HEADER_OVERFLOW);
+            return len;
+        }
+    }
+    state_ = state;
+    SuspendSpan(parser, settings, state, mark, end);
+    return len;
+}
+
+inline bool DfaEngine::EndSpan(http_parser* parser, const http_parser_settings* settings,
+                               uint8_t state, const char* mark, const char* p) {
+    using namespace dfa;
+    const char* s = mark;
+    size_t len = p - mark;
+    if (!token_.empty()) {
+        token_.append(mark, len);
+        s = token_.data();
+        len = token_.size();
+    }
+
+    bool ok = true;
+    switch (state) {
+        case kMethod: {
+            int method = LookupMethod(s, len);
+            if (method < 0)
+                ok = Fail(parser, HPE_INVALID_METHOD);
+            else
+                parser->method = method;
+            break;
+        }
+        case kUrl:
+            // 只有scheme或者scheme://的uri不完整
+            if (url_state_ >= s_req_schema && url_state_ <= s_req_server_start)
+                ok = Fail(parser, HPE_INVALID_URL);
+            else
+                ok = Data(parser, settings->on_url, HPE_CB_url, mark, p - mark);
+            break;
+        case kStatusCode: {
+            // 和http-parser一样接受1到3位以及有前导0的状态码
+            unsigned code = 0;
+            for (size_t i = 0; ok && i < len; ++i) {
+                code = code * 10 + (s[i] - '0');
+                if (code > 999) ok = Fail(parser, HPE_INVALID_STATUS);
+            }
+            parser->status_code = code;
+            break;
+        }
+        case kReason:
+            ok = Data(parser, settings->on_status, HPE_CB_status, mark, p - mark);
+            break;
+        case kField:
+            field_ = SpecialFieldOf(s, len);
+            ok = Data(parser, settings->on_header_field, HPE_CB_header_field, mark, p - mark);
+            break;
+        case kValue:
+            ok = Data(parser, settings->on_header_value, HPE_CB_header_value, mark, p - mark) &&
+                 OnValue(parser, s, len);
+            break;
+        case kChunkSize: {
+            uint64_t size = 0;
+            for (size_t i = 0; i < len; ++i) {
+                if (size >> 60) {
+                    ok = Fail(parser, HPE_INVALID_CHUNK_SIZE);
+                    break;
+                }
+                size = size * 16 + HexValue(s[i]);
+            }
+            parser->content_length = size;
+            break;
+        }
+    }
+    token_.clear();
+    return ok;
+}
+
+inline bool DfaEngine::SuspendSpan(http_parser* parser, const http_parser_settings* settings,
+                                   uint8_t state, const char* mark, const char* end) {
+    using namespace dfa;
+    switch (state) {
+        case kMethod:
+        case kStatusCode:
+        case kChunkSize:
+            token_.append(mark, end - mark);
+            return true;
+        case kUrl:
+            return ScanUrl(parser, mark, &end) &&
+                   Data(parser, settings->on_url, HPE_CB_url, mark, end - mark);
+        case kReason:
+            return Data(parser, settings->on_status, HPE_CB_status, mark, end - mark);
+        case kField:
+            token_.append(mark, end - mark);
+            return Data(parser, settings->on_header_field, HPE_CB_header_field, mark, end - mark);
+        case kValue:
+            if (field_ != kFieldOther) token_.append(mark, end - mark);
+            return Data(parser, settings->on_header_value, HPE_CB_header_value, mark, end - mark);
+        default:
+            return true;
+    }
+}
+
+inline bool DfaEngine::OnValue(http_parser* parser, const char* s, size_t len) {
+    using namespace dfa;
+    const char* last = s + len;
+    while (last > s && detail::IsOWS(last[-1])) --last;
+
+    switch (field_) {
+        case kFieldContentLength: {
+            if (parser->flags & F_CONTENTLENGTH) return Fail(parser, HPE_UNEXPECTED_CONTENT_LENGTH);
+            uint64_t length = 0;
+            if (s == last) return Fail(parser, HPE_INVALID_CONTENT_LENGTH);
+            for (; s < last; ++s) {
+                if (*s < '0' || *s > '9' || length > (ULLONG_MAX - 10) / 10)
+                    return Fail(parser, HPE_INVALID_CONTENT_LENGTH);
+                length = length * 10 + (*s - '0');
+            }
+            parser->content_length = length;
+            parser->flags |= F_CONTENTLENGTH;
+            break;
+        }
+        case kFieldTransferEncoding: {
+            // chunked必须是最后一个编码
+            parser->uses_transfer_encoding = 1;
+            const char *first = nullptr, *stop = nullptr, *element, *element_end;
+            while (detail::NextListElement(s, last, &element, &element_end)) {
+                first = element;
+                stop = element_end;
+            }
+            if (first && EqualsNoCase(first, stop - first, "chunked", 7))
+                parser->flags |= F_CHUNKED;
+            else
+                parser->flags &= ~F_CHUNKED;
+            break;
+        }
+        case kFieldConnection: {
+            const char *element, *element_end;
+            while (detail::NextListElement(s, last, &element, &element_end)) {
+                size_t n = element_end - element;
+                if (EqualsNoCase(element, n, "keep-alive", 10))
+                    parser->flags |= F_CONNECTION_KEEP_ALIVE;
+                else if (EqualsNoCase(element, n, "close", 5))
+                    parser->flags |= F_CONNECTION_CLOSE;
+                else if (EqualsNoCase(element, n, "upgrade", 7))
+                    parser->flags |= F_CONNECTION_UPGRADE;
+            }
+            break;
+        }
+        case kFieldUpgrade:
+            parser->flags |= F_UPGRADE;
+            break;
+    }
+    field_ = kFieldOther;
+    return true;
+}
+
+inline bool DfaEngine::ScanUrl(http_parser* parser, const char* s, const char** end) {
+    uint8_t url_state = url_state_;
+    for (; s < *end; ++s) {
+        url_state = parse_url_char((enum state)url_state, *s);
+        if (url_state == s_dead) {
+            *end = s;
+            return Fail(parser, HPE_INVALID_URL);
+        }
+    }
+    url_state_ = url_state;
+    return true;
+}
+
+inline uint8_t DfaEngine::HeadersDone(http_parser* parser, const http_parser_settings* settings) {
+    using namespace dfa;
+    unsigned flags = parser->flags;
+    if (flags & F_TRAILING) {
+        if (!Notify(parser, settings->on_chunk_complete, HPE_CB_chunk_complete)) return kDead;
+        return MessageDone(parser, settings) ? state_ : (uint8_t)kDead;
+    }
+
+    if ((flags & F_UPGRADE) && (flags & F_CONNECTION_UPGRADE))
+        parser->upgrade = parser->type == HTTP_REQUEST || parser->status_code == 101;
+    else
+        parser->upgrade = parser->type == HTTP_REQUEST && parser->method == HTTP_CONNECT;
+
+    // Transfer-Encoding和Content-Length不能同时出现(RFC 7230 3.3.3), 否则可以用来走私请求.
+    // 编码不是chunked时lenient_http_headers可以放行, 是chunked时要allow_chunked_length
+    if (parser->uses_transfer_encoding && (flags & F_CONTENTLENGTH) &&
+        ((flags & F_CHUNKED) ? !parser->allow_chunked_length : !parser->lenient_http_headers)) {
+        Fail(parser, HPE_UNEXPECTED_CONTENT_LENGTH);
+        return kDead;
+    }
+
+    // 返回1表示没有body(HEAD的response), 返回2表示upgrade
+    if (settings->on_headers_complete) {
+        switch (settings->on_headers_complete(parser)) {
+            case 0:
+                break;
+            case 2:
+                parser->upgrade = 1;
+                parser->flags |= F_SKIPBODY;
+                break;
+            case 1:
+                parser->flags |= F_SKIPBODY;
+                break;
+            default:
+                Fail(parser, HPE_CB_headers_complete);
+                return kDead;
+        }
+    }
+    if (HTTP_PARSER_ERRNO(parser) != HPE_OK) return kDead;
+
+    flags = parser->flags;
+    uint64_t length = parser->content_length;
+    bool has_body = (flags & F_CHUNKED) || (length > 0 && length != ULLONG_MAX);
+    if (parser->upgrade &&
+        (parser->method == HTTP_CONNECT || (flags & F_SKIPBODY) || !has_body)) {
+        return MessageDone(parser, settings) ? kStateCount : kDead;
+    }
+
+    if (flags & F_SKIPBODY) {
+    } else if (flags & F_CHUNKED) {
+        return kChunkSizeStart;
+    } else if (parser->uses_transfer_encoding) {
+        if (parser->type == HTTP_REQUEST && !parser->lenient_http_headers) {
+            Fail(parser, HPE_INVALID_TRANSFER_ENCODING);
+            return kDead;
+        }
+        return kBodyEof;
+    } else if (length != 0 && length != ULLONG_MAX) {
+        return kBodyIdentity;
+    } else if (length == ULLONG_MAX && http_message_needs_eof(parser)) {
+        return kBodyEof;
+    }
+    return MessageDone(parser, settings) ? state_ : (uint8_t)kDead;
+}
+
+inline bool DfaEngine::MessageDone(http_parser* parser, const http_parser_settings* settings) {
+    state_ = parser->type == HTTP_RESPONSE ? dfa::kResStart : dfa::kReqStart;
+    return Notify(parser, settings->on_message_complete, HPE_CB_message_complete);
+}
+
+inline const char* DfaEngine::Body(http_parser* parser, const http_parser_settings* settings,
+                                   const char* p, const char* end) {
+    using namespace dfa;
+    size_t n = end - p;
+    if (state_ != kBodyEof && parser->content_length < n) n = (size_t)parser->content_length;
+    if (n && !Data(parser, settings->on_body, HPE_CB_body, p, n)) return nullptr;
+    p += n;
+    if (state_ == kBodyEof) return p;
+
+    parser->content_length -= n;
+    if (parser->content_length == 0) {
+        if (state_ == kChunkData)
+            state_ = kChunkDataCr;
+        else if (!MessageDone(parser, settings))
+            return nullptr;
+    }
+    return p;
+}
+
+}  // namespace rapidhttp
@@ -1,12 +1,21 @@
 #pragma once
 
+#include <sys/uio.h>
+
 #include <algorithm>
 #include <cstdint>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include "cookie.h"
+#include "date_cache.h"
+#include "field_range.h"
+#include "header_info.h"
 #include "layer.hpp"
+#include "lookup_tables.h"
+#include "string_traits.h"
+#include "url.h"
 #include "util.h"
 
 namespace rapidhttp {
@@ -50,7 +59,11 @@ class TDocument {
           method_(other.method_),
           uri_or_status_(other.uri_or_status_),
           header_fields_(other.header_fields_),
-          body_(other.body_) {}
+          body_(other.body_),
+          date_field_(other.date_field_),
+          header_info_(other.header_info_),
+          url_(other.url_),
+          url_state_(other.url_state_) {}
 
     TDocument(TDocument&& other)
         : type_(other.type_),
@@ -59,7 +72,16 @@ class TDocument {
           method_(other.method_),
           uri_or_status_(std::move(other.uri_or_status_)),
           header_fields_(std::move(other.header_fields_)),
-          body_(std::move(other.body_)) {}
+          body_(std::move(other.body_)),
+          date_field_(other.date_field_),
+          header_info_(other.header_info_),
+          url_(other.url_),
+          url_state_(other.url_state_),
+          cache_(std::move(other.cache_)),
+          cache_fields_pos_(other.cache_fields_pos_),
+          cache_dirty_(other.cache_dirty_) {
+        other.Invalidate(kDirtyAll);
+    }
 
     TDocument& operator=(const TDocument& other) {
         type_ = other.type_, major_ = other.major_;
@@ -68,6 +90,11 @@ class TDocument {
         uri_or_status_ = other.uri_or_status_;
         header_fields_ = other.header_fields_;
         body_ = other.body_;
+        date_field_ = other.date_field_;
+        InvalidateCache(kDirtyAll);
+        header_info_ = other.header_info_;
+        url_ = other.url_;
+        url_state_ = other.url_state_;
         return *this;
     }
 
@@ -78,6 +105,14 @@ class TDocument {
         uri_or_status_ = std::move(other.uri_or_status_);
         header_fields_ = std::move(other.header_fields_);
         body_ = std::move(other.body_);
+        date_field_ = other.date_field_;
+        header_info_ = other.header_info_;
+        url_ = other.url_;
+        url_state_ = other.url_state_;
+        cache_ = std::move(other.cache_);
+        cache_fields_pos_ = other.cache_fields_pos_;
+        cache_dirty_ = other.cache_dirty_;
+        other.Invalidate(kDirtyAll);
         return *this;
     }
 
@@ -89,7 +124,11 @@ class TDocument {
           method_(other.method_),
           uri_or_status_(other.uri_or_status_.data(), other.uri_or_status_.size()),
           header_fields_(),
-          body_(other.body_.data(), other.body_.size()) {
+          body_(other.body_.data(), other.body_.size()),
+          date_field_(other.date_field_),
+          header_info_(other.header_info_),
+          url_(other.url_),
+          url_state_(other.url_state_) {
         for (const auto& h : other.header_fields_) {
             header_fields_.emplace_back(std::make_pair(string_t(h.first.data(), h.first.size()),
                                                        string_t(h.second.data(), h.second.size())));
@@ -106,6 +145,11 @@ class TDocument {
                                                        string_t(h.second.data(), h.second.size())));
         }
         body_ = string_t(other.body_.data(), other.body_.size());
+        date_field_ = other.date_field_;
+        InvalidateCache(kDirtyAll);
+        header_info_ = other.header_info_;
+        url_ = other.url_;
+        url_state_ = other.url_state_;
         return *this;
     }
     ~TDocument() = default;
@@ -118,20 +162,39 @@ class TDocument {
     /// Serialize后的数据长度
     inline size_t ByteSize() const noexcept;
 
+    /// 生成起始行和域的序列化缓存
+    // 之后的序列化只需要拷贝缓存和body, body不进入缓存. Set*接口只会让受影响的
+    // 部分失效, 未失效的部分仍然从缓存拷贝. 序列化接口都是只读的, 不会填充缓存,
+    // 同一个document(比如发给很多客户端的同一个response)准备好缓存之后可以在
+    // 多个线程中同时序列化.
+    // @returns: document未初始化时返回false
+    inline bool PrepareCache();
+
     /// 序列化
     inline bool Serialize(char* buf, size_t len) const noexcept;
     inline std::string SerializeAsString() const;
+
+    /// SerializeToIovec需要的iovec数量
+    inline size_t IovecCount() const noexcept;
+
+    /// 零拷贝序列化, 可直接交给writev
+    // iovec直接指向document中的字符串和静态的分隔符/状态行片段,
+    // 在document被修改或析构之前有效. Date域指向当前线程的DateCache快照.
+    // @returns: 使用的iovec数量, document未初始化或n不足时返回0
+    inline size_t SerializeToIovec(struct iovec* out, size_t n) const noexcept;
     /// --------------------------------------------------------
 
     /// ------------------- fields get/set ---------------------
     inline uint32_t GetMajor() const noexcept { return major_; }
     inline this_type& SetMajor(uint32_t major) noexcept {
         major_ = major;
+        Invalidate(kDirtyStartLine);
         return *this;
     }
     inline uint32_t GetMinor() const noexcept { return minor_; }
     inline this_type& SetMinor(uint32_t minor) noexcept {
         minor_ = minor;
+        Invalidate(kDirtyStartLine);
         return *this;
     }
     inline uint32_t GetVersion() const noexcept { return major_ * 10 + minor_; }
@@ -139,11 +202,13 @@ class TDocument {
         assert(version < 100);
         major_ = version / 10;
         minor_ = version % 10;
+        Invalidate(kDirtyStartLine);
         return *this;
     }
     inline http_method GetMethod() const noexcept { return (http_method)method_; }
     inline this_type& SetMethod(http_method method) noexcept {
         method_ = method;
+        Invalidate(kDirtyStartLine);
         return *this;
     }
 
@@ -152,49 +217,99 @@ class TDocument {
     }
 
     inline string_t const& GetUri() const noexcept { return uri_or_status_; }
+    /// URI的解析结果, 第一次访问时调用http_parser_parse_url并缓存
+    // CONNECT请求按authority-form(host:port)解析. URI不合法时返回nullptr.
+    inline const http_parser_url* GetParsedUri() const noexcept {
+        if (!url_state_) {
+            const string_t& uri = uri_or_status_;
+            url_state_ = (uri.size() <= UINT16_MAX &&
+                          http_parser_parse_url(uri.data(), uri.size(), method_ == HTTP_CONNECT,
+                                                &url_) == 0)
+                             ? 1
+                             : -1;
+        }
+        return url_state_ > 0 ? &url_ : nullptr;
+    }
+    /// 原地规范化URI的路径部分, 见NormalizePath
+    // 直接改写URI的存储, 不分配内存. 借用型的string_t(StringRef, string_view)
+    // 会改写它引用的缓冲区, 要求缓冲区可写.
+    // @returns: URI没有路径部分(如CONNECT的authority-form)时返回false
+    inline bool NormalizeUri() noexcept {
+        size_t pos = 0;
+        if (uri_or_status_.empty() || uri_or_status_[0] != '/') {
+            const http_parser_url* u = GetParsedUri();
+            if (!u || !(u->field_set & (1 << UF_PATH))) return false;
+            pos = u->field_data[UF_PATH].off;
+        }
+        char* data = StringTraits<string_t>::mutable_data(uri_or_status_);
+        size_t len = NormalizePath(data + pos, uri_or_status_.size() - pos);
+        StringTraits<string_t>::truncate(uri_or_status_, pos + len);
+        Invalidate(kDirtyStartLine);
+        return true;
+    }
     inline this_type& SetUri(const char* uri) {
         uri_or_status_ = uri;
+        Invalidate(kDirtyStartLine);
         return *this;
     }
     template <class OStringT>
     inline this_type& SetUri(const OStringT& uri) {
         uri_or_status_ = uri;
+        Invalidate(kDirtyStartLine);
         return *this;
     }
     inline this_type& SetUri(const string_t& uri) {
         uri_or_status_ = uri;
+        Invalidate(kDirtyStartLine);
         return *this;
     }
     inline this_type& SetUri(string_t&& uri) {
         uri_or_status_ = uri;
+        Invalidate(kDirtyStartLine);
         return *this;
     }
     inline uint16_t GetStatusCode() const noexcept { return status_code_; }
     inline this_type& SetStatusCode(uint16_t code) noexcept {
         status_code_ = code;
+        Invalidate(kDirtyStartLine);
         return *this;
     }
     inline this_type& SetStatus(uint16_t code, const char* status = nullptr) {
         status_code_ = code;
+        if (!status) status = StatusReason(code);
         uri_or_status_ = status ? status : http_status_str((http_status)code);
+        Invalidate(kDirtyStartLine);
         return *this;
     }
     inline string_t const& GetStatus() const noexcept { return uri_or_status_; }
     inline this_type& SetStatus(const char* status) {
         uri_or_status_ = status;
+        Invalidate(kDirtyStartLine);
         return *this;
     }
     template <class OStringT>
     inline this_type& SetStatus(const OStringT& status) {
         uri_or_status_ = status;
+        Invalidate(kDirtyStartLine);
         return *this;
     }
     inline this_type& SetStatus(const string_t& status) {
         uri_or_status_ = status;
+        Invalidate(kDirtyStartLine);
         return *this;
     }
     inline this_type& SetStatus(string_t&& status) {
         uri_or_status_ = status;
+        Invalidate(kDirtyStartLine);
+        return *this;
+    }
+
+    /// 序列化时自动带上当前时间的Date域(来自DateCache, 每秒刷新)
+    // 不占用header_fields_, Reset()之后保持不变. 序列化缓存中不包含Date域,
+    // 每次序列化时插在起始行和缓存的域之间, 所以开关Date域不会让缓存失效.
+    inline bool HasDateField() const noexcept { return date_field_; }
+    inline this_type& SetDateField(bool on = true) noexcept {
+        date_field_ = on;
         return *this;
     }
 
@@ -218,6 +333,58 @@ class TDocument {
     }
 
     inline headers_type const& GetFields() const noexcept { return header_fields_; }
+
+    /// ------------------- typed fields ---------------------
+    // 解析时已经填好, 不需要再查找域和解析值. 修改过版本号或域之后, 第一次访问时重新扫描.
+    inline HeaderInfo const& GetHeaderInfo() const noexcept {
+        if (!header_info_.valid) BuildHeaderInfo();
+        return header_info_;
+    }
+    inline bool HasContentLength() const noexcept {
+        return GetHeaderInfo().flags & HeaderInfo::kHasContentLength;
+    }
+    /// 没有Content-Length时返回0
+    inline uint64_t ContentLength() const noexcept { return GetHeaderInfo().content_length; }
+    inline bool KeepAlive() const noexcept { return GetHeaderInfo().flags & HeaderInfo::kKeepAlive; }
+    inline bool IsChunked() const noexcept { return GetHeaderInfo().flags & HeaderInfo::kChunked; }
+    inline bool IsUpgrade() const noexcept { return GetHeaderInfo().flags & HeaderInfo::kUpgrade; }
+    inline bool ExpectContinue() const noexcept {
+        return GetHeaderInfo().flags & HeaderInfo::kExpectContinue;
+    }
+    /// eCacheControl的位域
+    inline uint16_t CacheControl() const noexcept { return GetHeaderInfo().cache_control; }
+    /// Cache-Control的max-age, 没有时返回-1
+    inline int64_t MaxAge() const noexcept { return GetHeaderInfo().max_age; }
+    inline string_t const& Host() const noexcept {
+        int32_t index = GetHeaderInfo().host_index;
+        return index < 0 ? empty_string : header_fields_[index].second;
+    }
+
+    /// Cookie域中的cookie, 指向域的值(名字不区分大小写, 只取第一个Cookie域)
+    inline CookieRange Cookies() const noexcept {
+        string_t const* cookie = FindFieldNoCase("cookie", 6);
+        return cookie ? CookieRange(cookie->data(), cookie->size()) : CookieRange();
+    }
+    inline bool FindCookie(const char* name, StringRef* value) const noexcept {
+        return Cookies().Find(name, value);
+    }
+
+    /// 同名域的所有值(名字不区分大小写), 如多个Set-Cookie
+    inline TFieldRange<string_t> GetFieldValues(const char* key) const noexcept {
+        return TFieldRange<string_t>(header_fields_, key, strlen(key));
+    }
+    /// 所有同名列表域中的元素, 如X-Forwarded-For, Via, Cache-Control
+    inline TListRange<string_t> GetFieldElements(const char* key) const noexcept {
+        return TListRange<string_t>(GetFieldValues(key));
+    }
+
+    /// 忽略大小写查找域, lower必须是小写的
+    inline string_t const* FindFieldNoCase(const char* lower, size_t len) const noexcept {
+        for (const auto& h : header_fields_)
+            if (EqualsNoCase(h.first.data(), h.first.size(), lower, len)) return &h.second;
+        return nullptr;
+    }
+
     inline string_t const* FindField(const char* key) const noexcept {
         for (const auto& h : header_fields_)
             if (h.first == key) return &h.second;
@@ -265,6 +432,7 @@ class TDocument {
         else
             it->second = h.second;
 
+        Invalidate(kDirtyFields);
         return *this;
     }
 
@@ -277,6 +445,7 @@ class TDocument {
         else
             it->second = std::move(h.second);
 
+        Invalidate(kDirtyFields);
         return *this;
     }
 
@@ -292,6 +461,7 @@ class TDocument {
             header_fields_.emplace_back(key, value);
         else
             it->second = value;
+        Invalidate(kDirtyFields);
         return *this;
     }
 
@@ -333,6 +503,32 @@ class TDocument {
     inline bool CheckStatus() const noexcept;
     inline bool CheckVersion() const noexcept;
 
+    /// ------------------- serialize cache ---------------------
+    enum : uint8_t {
+        kDirtyStartLine = 1 << 0,
+        kDirtyFields = 1 << 1,
+        kDirtyAll = kDirtyStartLine | kDirtyFields,
+    };
+    inline void Invalidate(uint8_t parts) noexcept {
+        InvalidateCache(parts);
+        if (parts & (kDirtyStartLine | kDirtyFields)) header_info_.valid = false;
+        if (parts & kDirtyStartLine) url_state_ = 0;
+    }
+    inline void InvalidateCache(uint8_t parts) noexcept { cache_dirty_ |= parts; }
+    inline void BuildHeaderInfo() const noexcept;
+    inline size_t StartLineByteSize() const noexcept;
+    inline size_t FieldsByteSize() const noexcept;
+    inline char* WriteStartLine(char* buf) const noexcept;
+    inline char* WriteFields(char* buf) const noexcept;
+
+    /// 按顺序取序列化数据的第index段, 没有更多数据时返回false
+    // @use_cache: 是否使用序列化缓存(起始行, Date域, 其它域, body各一段), 要求缓存有效
+    inline bool GetPiece(size_t index, bool use_cache, struct iovec* piece) const noexcept;
+    /// GetPiece中Date域那一段的序号, 没有Date域时返回-1
+    inline size_t DatePieceIndex(bool use_cache) const noexcept {
+        return !date_field_ ? (size_t)-1 : use_cache ? 1 : 4;
+    }
+
   private:
     uint8_t type_{HTTP_BOTH};
     // 默认版本号: HTTP/1.1
@@ -348,10 +544,28 @@ class TDocument {
 
     string_t body_;
 
-    template <typename>
+    // 序列化时在起始行之后插入DateCache的Date域
+    bool date_field_{false};
+
+    // 常用域的解析结果, 见HeaderInfo
+    mutable HeaderInfo header_info_;
+
+    // URI的解析结果, url_state_: 0未解析, 1合法, -1不合法
+    mutable http_parser_url url_;
+    mutable int8_t url_state_{0};
+
+    // 序列化缓存: [起始行][域+空行], 不含Date域, 由PrepareCache生成, 只有cache_dirty_
+    // 为0时才完整有效, 否则其中未标记为dirty的部分仍可复用.
+    std::string cache_;
+    uint32_t cache_fields_pos_{0};
+    uint8_t cache_dirty_{kDirtyAll};
+
+    template <typename, typename, typename, typename>
     friend class TParser;
     template <typename>
     friend class TDocument;
+    template <typename>
+    friend class TSerializeCursor;
 };
 template <typename StringT>
 inline void TDocument<StringT>::Reset() {
@@ -359,9 +573,29 @@ inline void TDocument<StringT>::Reset() {
     minor_ = 1;
     //   request_method_.clear();
     status_code_ = -1;
-    uri_or_status_.clear();
+    StringTraits<string_t>::clear(uri_or_status_);
     header_fields_.clear();
-    body_.clear();
+    StringTraits<string_t>::clear(body_);
+    Invalidate(kDirtyAll);
+    header_info_.Clear();
+}
+template <typename StringT>
+inline void TDocument<StringT>::BuildHeaderInfo() const noexcept {
+    header_info_.Clear();
+    uint8_t connection = 0;
+    for (size_t i = 0; i < header_fields_.size(); ++i) {
+        auto const& kv = header_fields_[i];
+        header_info_.OnField(kv.first.data(), kv.first.size(), kv.second.data(), kv.second.size(),
+                             i, &connection);
+    }
+    // HTTP/1.1默认长连接, HTTP/1.0需要显式的keep-alive
+    bool keep_alive = (major_ > 1 || (major_ == 1 && minor_ >= 1))
+                          ? !(connection & HeaderInfo::kConnectionClose)
+                          : (connection & HeaderInfo::kConnectionKeepAlive);
+    if (keep_alive) header_info_.flags |= HeaderInfo::kKeepAlive;
+    if ((connection & HeaderInfo::kConnectionUpgrade) && (connection & HeaderInfo::kUpgradeField))
+        header_info_.flags |= HeaderInfo::kUpgrade;
+    header_info_.valid = true;
 }
 template <typename StringT>
 inline bool TDocument<StringT>::CheckMethod() const noexcept {
@@ -394,9 +628,7 @@ inline bool TDocument<StringT>::IsInitialized() const noexcept {
 }
 
 template <typename StringT>
-inline size_t TDocument<StringT>::ByteSize() const noexcept {
-    if (!IsInitialized()) return 0;
-
+inline size_t TDocument<StringT>::StartLineByteSize() const noexcept {
     size_t bytes = 0;
     if (IsRequest()) {
         // bytes += request_method_.size() + 1;  // GET\s
@@ -408,18 +640,31 @@ inline size_t TDocument<StringT>::ByteSize() const noexcept {
         bytes += UIntegerByteSize(GetStatusCode()) + 1;  // 200\s
         bytes += GetStatus().size() + 2;                 // okCRLF
     }
+    return bytes;
+}
+
+template <typename StringT>
+inline size_t TDocument<StringT>::FieldsByteSize() const noexcept {
+    size_t bytes = 0;
     for (auto const& kv : header_fields_) {
         bytes += kv.first.size() + 2 + kv.second.size() + 2;
     }
     bytes += 2;
-    bytes += body_.size();
     return bytes;
 }
 
 template <typename StringT>
-inline bool TDocument<StringT>::Serialize(char* buf, size_t len) const noexcept {
-    size_t bytes = ByteSize();
-    if (!bytes || len < bytes) return false;
+inline size_t TDocument<StringT>::ByteSize() const noexcept {
+    size_t bytes = date_field_ ? DateCache::c_line_size : 0;
+    if (!cache_dirty_) return bytes + cache_.size() + body_.size();
+    if (!IsInitialized()) return 0;
+
+    bytes += (cache_dirty_ & kDirtyStartLine) ? StartLineByteSize() : cache_fields_pos_;
+    bytes += (cache_dirty_ & kDirtyFields) ? FieldsByteSize() : cache_.size() - cache_fields_pos_;
+    bytes += body_.size();
+    return bytes;
+}
+
 #define _WRITE_STRING(ss)                  \
     do {                                   \
         memcpy(buf, ss.data(), ss.size()); \
@@ -436,7 +681,8 @@ inline bool TDocument<StringT>::Serialize(char* buf, size_t len) const noexcept
     *buf++ = '\r';    \
     *buf++ = '\n'
 
-    char* ori = buf;
+template <typename StringT>
+inline char* TDocument<StringT>::WriteStartLine(char* buf) const noexcept {
     if (IsRequest()) {
         // _WRITE_STRING(request_method_);
         _WRITE_C_STR(http_method_str(GetMethod()), http_method_str_len(GetMethod()));
@@ -447,6 +693,14 @@ inline bool TDocument<StringT>::Serialize(char* buf, size_t len) const noexcept
         *buf++ = '.';
         *buf++ = minor_ + '0';
     } else {
+        // HTTP/1.1 + 标准原因短语: 直接拷贝预渲染的状态行
+        const StatusEntry* entry = FindStatus(GetStatusCode());
+        if (major_ == 1 && minor_ == 1 && entry && entry->reason &&
+            entry->reason_len == GetStatus().size() &&
+            memcmp(entry->reason, GetStatus().data(), entry->reason_len) == 0) {
+            _WRITE_C_STR(entry->line, entry->line_len);
+            return buf;
+        }
         _WRITE_C_STR("HTTP/", 5);
         *buf++ = major_ + '0';
         *buf++ = '.';
@@ -459,6 +713,11 @@ inline bool TDocument<StringT>::Serialize(char* buf, size_t len) const noexcept
         _WRITE_STRING(GetStatus());
     }
     _WRITE_CRLF();
+    return buf;
+}
+
+template <typename StringT>
+inline char* TDocument<StringT>::WriteFields(char* buf) const noexcept {
     for (auto const& kv : header_fields_) {
         _WRITE_STRING(kv.first);
         *buf++ = ':';
@@ -467,13 +726,47 @@ inline bool TDocument<StringT>::Serialize(char* buf, size_t len) const noexcept
         _WRITE_CRLF();
     }
     _WRITE_CRLF();
-    _WRITE_STRING(body_);
-    size_t length = buf - ori;
-    (void)length;
-    return true;
+    return buf;
+}
+
 #undef _WRITE_CRLF
 #undef _WRITE_C_STR
 #undef _WRITE_STRING
+
+template <typename StringT>
+inline bool TDocument<StringT>::PrepareCache() {
+    if (!IsInitialized()) return false;
+    size_t start_line = StartLineByteSize();
+    cache_.resize(start_line + FieldsByteSize());
+    WriteFields(WriteStartLine(&cache_[0]));
+    cache_fields_pos_ = (uint32_t)start_line;
+    cache_dirty_ = 0;
+    return true;
+}
+
+template <typename StringT>
+inline bool TDocument<StringT>::Serialize(char* buf, size_t len) const noexcept {
+    size_t bytes = ByteSize();
+    if (!bytes || len < bytes) return false;
+
+    // 未失效的部分直接从缓存拷贝, 失效的部分重新生成
+    char* pos = buf;
+    if (cache_dirty_ & kDirtyStartLine) {
+        pos = WriteStartLine(pos);
+    } else {
+        memcpy(pos, cache_.data(), cache_fields_pos_);
+        pos += cache_fields_pos_;
+    }
+    if (date_field_) pos = DateCache::Instance().Write(pos);
+    if (cache_dirty_ & kDirtyFields) {
+        pos = WriteFields(pos);
+    } else {
+        size_t fields_size = cache_.size() - cache_fields_pos_;
+        memcpy(pos, cache_.data() + cache_fields_pos_, fields_size);
+        pos += fields_size;
+    }
+    memcpy(pos, body_.data(), body_.size());
+    return true;
 }
 template <typename StringT>
 inline std::string TDocument<StringT>::SerializeAsString() const {
@@ -484,9 +777,123 @@ inline std::string TDocument<StringT>::SerializeAsString() const {
     if (!Serialize(&s[0], bytes)) return "";
     return s;
 }
+template <typename StringT>
+inline size_t TDocument<StringT>::IovecCount() const noexcept {
+    if (!cache_dirty_) return 2 + date_field_ + !body_.empty();
+
+    // 起始行4段, Date域1段, 每个域4段, 空行1段(有域时并入最后一个域的CRLF), body 1段
+    size_t count = 4 + date_field_ + header_fields_.size() * 4;
+    if (header_fields_.empty()) ++count;
+    if (!body_.empty()) ++count;
+    return count;
+}
+
+template <typename StringT>
+inline bool TDocument<StringT>::GetPiece(size_t index, bool use_cache,
+                                         struct iovec* piece) const noexcept {
+    static const char c_field_sep[] = ": ";
+    static const char c_crlf_crlf[] = "\r\n\r\n";
+
+#define _PIECE_C_STR(c_str, length)       \
+    do {                                  \
+        piece->iov_base = (void*)(c_str); \
+        piece->iov_len = (length);        \
+        return true;                      \
+    } while (0)
+
+#define _PIECE_STRING(ss) _PIECE_C_STR(ss.data(), ss.size())
+
+    if (use_cache) {
+        // Date域指向当前线程的DateCache快照, 不修改共享的缓存
+        if (index == 0) _PIECE_C_STR(cache_.data(), cache_fields_pos_);
+        if (date_field_) {
+            if (index == 1) _PIECE_C_STR(DateCache::Instance().Line(), DateCache::c_line_size);
+            --index;
+        }
+        if (index == 1)
+            _PIECE_C_STR(cache_.data() + cache_fields_pos_, cache_.size() - cache_fields_pos_);
+        if (index == 2 && !body_.empty()) _PIECE_STRING(body_);
+        return false;
+    }
+
+    // 起始行4段
+    if (index < 4) {
+        const detail::SerializePieces& pieces = detail::SerializePieces::Instance();
+        if (IsRequest()) {
+            switch (index) {
+                case 0:
+                    _PIECE_C_STR(http_method_str(GetMethod()), http_method_str_len(GetMethod()));
+                case 1:
+                    _PIECE_C_STR(" ", 1);
+                case 2:
+                    _PIECE_STRING(GetUri());
+                default:
+                    _PIECE_C_STR(pieces.request_suffix[GetVersion()], 11);
+            }
+        } else {
+            switch (index) {
+                case 0:
+                    _PIECE_C_STR(pieces.response_prefix[GetVersion()], 9);
+                case 1:
+                    _PIECE_C_STR(pieces.status_code[GetStatusCode()], 4);
+                case 2:
+                    _PIECE_STRING(GetStatus());
+                default:
+                    _PIECE_C_STR(c_crlf_crlf, 2);
+            }
+        }
+    }
+    index -= 4;
+
+    if (date_field_) {
+        if (index == 0) _PIECE_C_STR(DateCache::Instance().Line(), DateCache::c_line_size);
+        --index;
+    }
+
+    // 每个域4段, 空行并入最后一个域的CRLF
+    size_t field_pieces = header_fields_.size() * 4;
+    if (index < field_pieces) {
+        auto const& kv = header_fields_[index / 4];
+        switch (index % 4) {
+            case 0:
+                _PIECE_STRING(kv.first);
+            case 1:
+                _PIECE_C_STR(c_field_sep, 2);
+            case 2:
+                _PIECE_STRING(kv.second);
+            default:
+                _PIECE_C_STR(c_crlf_crlf, index + 1 == field_pieces ? 4 : 2);
+        }
+    }
+    index -= field_pieces;
+
+    if (!field_pieces) {
+        if (index == 0) _PIECE_C_STR(c_crlf_crlf, 2);
+        --index;
+    }
+
+    if (index == 0 && !body_.empty()) _PIECE_STRING(body_);
+    return false;
+#undef _PIECE_STRING
+#undef _PIECE_C_STR
+}
+
+template <typename StringT>
+inline size_t TDocument<StringT>::SerializeToIovec(struct iovec* out, size_t n) const noexcept {
+    if (!IsInitialized() || n < IovecCount()) return 0;
+
+    bool use_cache = !cache_dirty_;
+    size_t count = 0;
+    while (GetPiece(count, use_cache, out + count)) ++count;
+    return count;
+}
+
 template <typename StringT>
 const StringT TDocument<StringT>::empty_string;
 
 using Document = TDocument<std::string>;
+#if RAPIDHTTP_HAS_STRING_VIEW
+using ViewDocument = TDocument<std::string_view>;
+#endif
 // using RefDocument = TDocument<StringRef>;
 }  // namespace rapidhttp
@@ -11,6 +11,7 @@ enum class eErrorCode {
     success = 0,
     parse_progress = 1,
     parse_error = 2,
+    feature_disabled = 3,  // 消息用到了TParser编译期关闭的功能
 };
 
 class ErrorCategory : public std::error_category {
@@ -25,6 +26,9 @@ class ErrorCategory : public std::error_category {
             case (int)eErrorCode::parse_error:
                 return "parse error";
 
+            case (int)eErrorCode::feature_disabled:
+                return "parser feature disabled";
+
             default:
                 return "unkown error";
         }
@@ -0,0 +1,178 @@
+#pragma once
+
+#include <stddef.h>
+#include <string.h>
+
+#include <iterator>
+#include <utility>
+#include <vector>
+
+#include "stringref.h"
+#include "util.h"
+
+namespace rapidhttp {
+
+/// 同名域的所有值, 如多个Set-Cookie, Via, X-Forwarded-For
+// 名字不区分大小写, 只引用document中的域, 不分配内存.
+template <typename StringT>
+class TFieldIterator {
+  public:
+    using headers_type = std::vector<std::pair<StringT, StringT>>;
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = StringT;
+    using difference_type = ptrdiff_t;
+    using pointer = const StringT*;
+    using reference = const StringT&;
+
+    TFieldIterator() noexcept = default;
+    TFieldIterator(const headers_type* fields, const char* name, size_t len) noexcept
+        : fields_(fields), name_(name), len_(len), index_(0) {
+        Seek();
+    }
+
+    inline reference operator*() const noexcept { return (*fields_)[index_].second; }
+    inline pointer operator->() const noexcept { return &(*fields_)[index_].second; }
+    inline TFieldIterator& operator++() noexcept {
+        ++index_;
+        Seek();
+        return *this;
+    }
+    inline TFieldIterator operator++(int) noexcept {
+        TFieldIterator it = *this;
+        ++*this;
+        return it;
+    }
+    friend inline bool operator==(TFieldIterator const& lhs, TFieldIterator const& rhs) noexcept {
+        return lhs.Current() == rhs.Current();
+    }
+    friend inline bool operator!=(TFieldIterator const& lhs, TFieldIterator const& rhs) noexcept {
+        return !(lhs == rhs);
+    }
+
+  private:
+    inline void Seek() noexcept {
+        for (; index_ < fields_->size(); ++index_) {
+            auto const& key = (*fields_)[index_].first;
+            if (EqualsIgnoreCase(key.data(), key.size(), name_, len_)) return;
+        }
+        fields_ = nullptr;
+    }
+    // 结束时为nullptr
+    inline pointer Current() const noexcept { return fields_ ? operator->() : nullptr; }
+
+  private:
+    const headers_type* fields_{nullptr};
+    const char* name_{nullptr};
+    size_t len_{0};
+    size_t index_{0};
+};
+
+template <typename StringT>
+class TFieldRange {
+  public:
+    using headers_type = typename TFieldIterator<StringT>::headers_type;
+
+    TFieldRange(const headers_type& fields, const char* name, size_t len) noexcept
+        : fields_(&fields), name_(name), len_(len) {}
+
+    inline TFieldIterator<StringT> begin() const noexcept {
+        return TFieldIterator<StringT>(fields_, name_, len_);
+    }
+    inline TFieldIterator<StringT> end() const noexcept { return TFieldIterator<StringT>(); }
+
+    inline bool Empty() const noexcept { return begin() == end(); }
+    inline size_t Count() const noexcept { return std::distance(begin(), end()); }
+
+  private:
+    const headers_type* fields_;
+    const char* name_;
+    size_t len_;
+};
+
+/// 列表域(#rule, 如"Via: a, b" "Accept-Encoding: gzip, br")的元素
+// 依次遍历所有同名域中按','切分的元素, 引号内的','不切分, 元素已去掉两边空白.
+template <typename StringT>
+class TListIterator {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = StringRef;
+    using difference_type = ptrdiff_t;
+    using pointer = const StringRef*;
+    using reference = const StringRef&;
+
+    TListIterator() noexcept = default;
+    explicit TListIterator(TFieldIterator<StringT> field) noexcept : field_(field) {
+        if (field_ != TFieldIterator<StringT>()) {
+            pos_ = field_->data();
+            last_ = pos_ + field_->size();
+        }
+        Next();
+    }
+
+    inline reference operator*() const noexcept { return element_; }
+    inline pointer operator->() const noexcept { return &element_; }
+    inline TListIterator& operator++() noexcept {
+        Next();
+        return *this;
+    }
+    inline TListIterator operator++(int) noexcept {
+        TListIterator it = *this;
+        Next();
+        return it;
+    }
+    friend inline bool operator==(TListIterator const& lhs, TListIterator const& rhs) noexcept {
+        return lhs.current_ == rhs.current_;
+    }
+    friend inline bool operator!=(TListIterator const& lhs, TListIterator const& rhs) noexcept {
+        return !(lhs == rhs);
+    }
+
+  private:
+    inline void Next() noexcept {
+        const TFieldIterator<StringT> end;
+        const char *first, *stop;
+        while (field_ != end) {
+            if (detail::NextListElement(pos_, last_, &first, &stop)) {
+                element_ = StringRef(first, stop - first);
+                current_ = first;
+                return;
+            }
+            if (++field_ != end) {
+                pos_ = field_->data();
+                last_ = pos_ + field_->size();
+            }
+        }
+        current_ = nullptr;
+    }
+
+  private:
+    TFieldIterator<StringT> field_;
+    const char* pos_{nullptr};
+    const char* last_{nullptr};
+    const char* current_{nullptr};  // 当前元素的起始位置, 结束时为nullptr
+    StringRef element_;
+};
+
+template <typename StringT>
+class TListRange {
+  public:
+    explicit TListRange(TFieldRange<StringT> const& fields) noexcept : fields_(fields) {}
+
+    inline TListIterator<StringT> begin() const noexcept {
+        return TListIterator<StringT>(fields_.begin());
+    }
+    inline TListIterator<StringT> end() const noexcept { return TListIterator<StringT>(); }
+
+    /// 是否包含某个元素(不区分大小写), 如Connection中的"upgrade"
+    inline bool Contains(const char* token) const noexcept {
+        size_t len = strlen(token);
+        for (auto const& element : *this)
+            if (EqualsIgnoreCase(element.data(), element.size(), token, len)) return true;
+        return false;
+    }
+
+  private:
+    TFieldRange<StringT> fields_;
+};
+
+}  // namespace rapidhttp
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <stddef.h>
+
+#include "util.h"
+
+namespace rapidhttp {
+
+/// TParser默认保留全部域
+struct AllFields {
+    static constexpr bool c_all = true;
+    static inline bool Contains(const char*, size_t) noexcept { return true; }
+};
+
+namespace detail {
+inline bool MatchAnyField(const char*, size_t) noexcept { return false; }
+
+// 名字的长度在编译期确定, 展开后先比较长度, 只有长度相同时才比较内容
+template <size_t N, typename... Rest>
+inline bool MatchAnyField(const char* name, size_t len, const char (&field)[N],
+                          const Rest&... rest) noexcept {
+    return EqualsIgnoreCase(name, len, field, N - 1) || MatchAnyField(name, len, rest...);
+}
+}  // namespace detail
+
+/// 定义一个编译期确定的域集合, 作为TParser的第二个模板参数
+// 解析时不在集合中的域仍然会被http-parser校验, 但不会存入document,
+// 也不会产生拷贝或拼接. 名字大小写不敏感.
+//
+//   RAPIDHTTP_FIELD_SET(ApiFields, "Host", "Content-Length", "Authorization", "X-Request-Id");
+//   rapidhttp::TParser<std::string, ApiFields> parser(rapidhttp::HTTP_REQUEST);
+#define RAPIDHTTP_FIELD_SET(Type, ...)                                         \
+    struct Type {                                                              \
+        static constexpr bool c_all = false;                                   \
+        static inline bool Contains(const char* name, size_t len) noexcept {   \
+            return ::rapidhttp::detail::MatchAnyField(name, len, __VA_ARGS__); \
+        }                                                                      \
+    }
+
+}  // namespace rapidhttp
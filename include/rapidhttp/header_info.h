@@ -0,0 +1,195 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "util.h"
+
+namespace rapidhttp {
+
+/// Cache-Control指令的位域
+enum eCacheControl : uint16_t {
+    kCacheNoCache = 1 << 0,
+    kCacheNoStore = 1 << 1,
+    kCacheMaxAge = 1 << 2,  // 值见MaxAge()
+    kCacheSMaxAge = 1 << 3,
+    kCacheNoTransform = 1 << 4,
+    kCacheMustRevalidate = 1 << 5,
+    kCacheProxyRevalidate = 1 << 6,
+    kCachePublic = 1 << 7,
+    kCachePrivate = 1 << 8,
+    kCacheOnlyIfCached = 1 << 9,
+    kCacheImmutable = 1 << 10,
+    kCacheMaxStale = 1 << 11,
+    kCacheMinFresh = 1 << 12,
+    kCacheStaleWhileRevalidate = 1 << 13,
+    kCacheStaleIfError = 1 << 14,
+};
+
+namespace detail {
+struct CacheDirective {
+    const char* name;
+    uint8_t len;
+    uint16_t flag;
+};
+static const CacheDirective c_cache_directives[] = {
+    {"no-cache", 8, kCacheNoCache},
+    {"no-store", 8, kCacheNoStore},
+    {"max-age", 7, kCacheMaxAge},
+    {"s-maxage", 8, kCacheSMaxAge},
+    {"no-transform", 12, kCacheNoTransform},
+    {"must-revalidate", 15, kCacheMustRevalidate},
+    {"proxy-revalidate", 16, kCacheProxyRevalidate},
+    {"public", 6, kCachePublic},
+    {"private", 7, kCachePrivate},
+    {"only-if-cached", 14, kCacheOnlyIfCached},
+    {"immutable", 9, kCacheImmutable},
+    {"max-stale", 9, kCacheMaxStale},
+    {"min-fresh", 9, kCacheMinFresh},
+    {"stale-while-revalidate", 22, kCacheStaleWhileRevalidate},
+    {"stale-if-error", 14, kCacheStaleIfError},
+};
+}  // namespace detail
+
+/// 解析Cache-Control的值, 未知的指令忽略
+// @max_age: 有合法的max-age时写入其值
+inline uint16_t ParseCacheControl(const char* s, size_t len, int64_t* max_age) noexcept {
+    uint16_t flags = 0;
+    const char* last = s + len;
+    while (s < last) {
+        while (s < last && (detail::IsOWS(*s) || *s == ',')) ++s;
+        const char* name = s;
+        while (s < last && *s != '=' && *s != ',' && !detail::IsOWS(*s)) ++s;
+        size_t name_len = s - name;
+        while (s < last && detail::IsOWS(*s)) ++s;
+
+        const char* value = s;
+        size_t value_len = 0;
+        if (s < last && *s == '=') {
+            value = ++s;
+            if (s < last && *s == '"') {
+                value = ++s;
+                while (s < last && *s != '"') ++s;
+                value_len = s - value;
+                if (s < last) ++s;
+            } else {
+                while (s < last && *s != ',' && !detail::IsOWS(*s)) ++s;
+                value_len = s - value;
+            }
+        }
+        while (s < last && *s != ',') ++s;
+
+        for (auto const& d : detail::c_cache_directives) {
+            if (!EqualsNoCase(name, name_len, d.name, d.len)) continue;
+            uint64_t seconds;
+            if (d.flag == kCacheMaxAge) {
+                if (!ParseUInteger(value, value_len, &seconds) || seconds > INT32_MAX) break;
+                *max_age = (int64_t)seconds;
+            }
+            flags |= d.flag;
+            break;
+        }
+    }
+    return flags;
+}
+
+/// 常用域的解析结果
+// TParser在解析过程中顺带填充, 直接复用http-parser算出的content_length和
+// keep-alive/chunked标记. 手动构造或修改过域的document在第一次访问时扫描一遍域来补齐.
+struct HeaderInfo {
+    enum : uint8_t {
+        kHasContentLength = 1 << 0,
+        kKeepAlive = 1 << 1,
+        kChunked = 1 << 2,
+        kExpectContinue = 1 << 3,
+        kUpgrade = 1 << 4,
+    };
+
+    uint64_t content_length{0};
+    int64_t max_age{-1};
+    int32_t host_index{-1};  // Host在header_fields_中的下标
+    uint16_t cache_control{0};
+    uint8_t flags{0};
+    bool valid{false};
+
+    inline void Clear() noexcept { *this = HeaderInfo(); }
+
+    /// http-parser没有处理的域: Host, Expect, Cache-Control
+    inline void OnExtraField(const char* key, size_t key_len, const char* value, size_t value_len,
+                             size_t index) noexcept {
+        switch (key_len) {
+            case 4:
+                if (host_index < 0 && EqualsNoCase(key, key_len, "host", 4))
+                    host_index = (int32_t)index;
+                break;
+            case 6:
+                if (EqualsNoCase(key, key_len, "expect", 6) &&
+                    EqualsNoCase(value, value_len, "100-continue", 12))
+                    flags |= kExpectContinue;
+                break;
+            case 13:
+                if (EqualsNoCase(key, key_len, "cache-control", 13))
+                    cache_control |= ParseCacheControl(value, value_len, &max_age);
+                break;
+        }
+    }
+
+    /// 包括http-parser已经处理过的Content-Length, Transfer-Encoding, Connection
+    inline void OnField(const char* key, size_t key_len, const char* value, size_t value_len,
+                        size_t index, uint8_t* connection) noexcept {
+        switch (key_len) {
+            case 7:
+                if (EqualsNoCase(key, key_len, "upgrade", 7)) *connection |= kUpgradeField;
+                return;
+            case 10:
+                if (EqualsNoCase(key, key_len, "connection", 10))
+                    *connection |= ParseConnection(value, value_len);
+                return;
+            case 14:
+                if (EqualsNoCase(key, key_len, "content-length", 14) &&
+                    ParseUInteger(value, value_len, &content_length))
+                    flags |= kHasContentLength;
+                return;
+            case 17:
+                // 只有最后一个编码是chunked时才是chunked
+                if (EqualsNoCase(key, key_len, "transfer-encoding", 17)) {
+                    const char* last = value + value_len;
+                    while (last > value && detail::IsOWS(last[-1])) --last;
+                    size_t len = last - value;
+                    if (len >= 7 && EqualsNoCase(last - 7, 7, "chunked", 7) &&
+                        (len == 7 || last[-8] == ',' || detail::IsOWS(last[-8])))
+                        flags |= kChunked;
+                    else
+                        flags &= ~kChunked;
+                }
+                return;
+        }
+        OnExtraField(key, key_len, value, value_len, index);
+    }
+
+    enum : uint8_t {
+        kConnectionClose = 1 << 0,
+        kConnectionKeepAlive = 1 << 1,
+        kConnectionUpgrade = 1 << 2,
+        kUpgradeField = 1 << 3,  // 有Upgrade域
+    };
+    static inline uint8_t ParseConnection(const char* s, size_t len) noexcept {
+        uint8_t connection = 0;
+        const char* last = s + len;
+        while (s < last) {
+            while (s < last && (detail::IsOWS(*s) || *s == ',')) ++s;
+            const char* token = s;
+            while (s < last && *s != ',' && !detail::IsOWS(*s)) ++s;
+            size_t token_len = s - token;
+            if (EqualsNoCase(token, token_len, "close", 5))
+                connection |= kConnectionClose;
+            else if (EqualsNoCase(token, token_len, "keep-alive", 10))
+                connection |= kConnectionKeepAlive;
+            else if (EqualsNoCase(token, token_len, "upgrade", 7))
+                connection |= kConnectionUpgrade;
+        }
+        return connection;
+    }
+};
+
+}  // namespace rapidhttp
@@ -3037,11 +3037,4 @@ inline int http_method_str_len(http_method m) {
     };
     return ELEM_AT(method_string_lens, m, 9 /*<unkonwn>*/);
 }
-
-inline http_method get_http_method(const char* s) {
-    for (uint32_t i = 0; i < ARRAY_SIZE(method_strings); ++i) {
-        if (::strcmp(s, method_strings[i]) == 0) return http_method(i);
-    }
-    return http_method(0);
-}
 } //namespace rapidhttp
@@ -0,0 +1,158 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "layer.hpp"
+#include "util.h"
+
+namespace rapidhttp {
+
+/// ------------------- method ---------------------
+namespace detail {
+static constexpr const char* c_method_names[] = {
+#define XX(num, name, string) #string,
+    HTTP_METHOD_MAP(XX)
+#undef XX
+};
+static constexpr size_t c_method_count = sizeof(c_method_names) / sizeof(c_method_names[0]);
+static constexpr size_t c_method_min_len = 3;   // GET
+static constexpr size_t c_method_max_len = 11;  // UNSUBSCRIBE
+static constexpr size_t c_method_table_size = 128;
+
+// 完美哈希: 对现有的全部method无冲突(由下面的static_assert保证)
+constexpr size_t MethodHash(const char* s, size_t len) {
+    return ((uint8_t)s[0] * 2 + (uint8_t)s[len - 1] * 5 + (uint8_t)s[len - 2] * 17 + len) &
+           (c_method_table_size - 1);
+}
+
+constexpr size_t MethodHash(size_t m) {
+    return MethodHash(c_method_names[m], constLength(c_method_names[m]));
+}
+
+constexpr int8_t FindMethodOfSlot(size_t slot, size_t m = 0) {
+    return m >= c_method_count   ? -1
+           : MethodHash(m) == slot ? (int8_t)m
+                                   : FindMethodOfSlot(slot, m + 1);
+}
+
+constexpr bool IsPerfectMethodHash(size_t m = 0) {
+    return m >= c_method_count ||
+           (FindMethodOfSlot(MethodHash(m)) == (int8_t)m && IsPerfectMethodHash(m + 1));
+}
+static_assert(IsPerfectMethodHash(), "method hash collision, adjust MethodHash");
+
+template <typename Seq>
+struct MethodTable;
+
+template <size_t... I>
+struct MethodTable<IndexSequence<I...>> {
+    static constexpr int8_t slots[sizeof...(I)] = {FindMethodOfSlot(I)...};
+    static constexpr uint8_t lens[c_method_count] = {
+#define XX(num, name, string) (uint8_t) constLength(#string),
+        HTTP_METHOD_MAP(XX)
+#undef XX
+    };
+};
+template <size_t... I>
+constexpr int8_t MethodTable<IndexSequence<I...>>::slots[sizeof...(I)];
+template <size_t... I>
+constexpr uint8_t MethodTable<IndexSequence<I...>>::lens[c_method_count];
+
+using MethodTableType = MethodTable<MakeIndexSequence<c_method_table_size>::type>;
+}  // namespace detail
+
+/// 从原始字节查找method, 不需要'\0'结尾
+// @returns: http_method的值, 未知的method返回-1
+inline int LookupMethod(const char* s, size_t len) noexcept {
+    if (len < detail::c_method_min_len || len > detail::c_method_max_len) return -1;
+    int m = detail::MethodTableType::slots[detail::MethodHash(s, len)];
+    if (m < 0 || detail::MethodTableType::lens[m] != len ||
+        memcmp(s, detail::c_method_names[m], len) != 0)
+        return -1;
+    return m;
+}
+
+/// 兼容旧接口: 未知的method返回http_method(0)
+inline http_method get_http_method(const char* s) {
+    int m = LookupMethod(s, strlen(s));
+    return http_method(m < 0 ? 0 : m);
+}
+
+/// ------------------- status ---------------------
+// http-parser的HTTP_STATUS_MAP之外的标准状态码
+#define RAPIDHTTP_EXTRA_STATUS_MAP(XX) \
+    XX(103, "Early Hints")             \
+    XX(418, "I'm a teapot")            \
+    XX(425, "Too Early")
+
+// 原因短语和http-parser的HTTP_STATUS_MAP不同的状态码(RFC 9110的新名称),
+// 排在HTTP_STATUS_MAP之前, 优先匹配
+#define RAPIDHTTP_OVERRIDE_STATUS_MAP(XX) \
+    XX(413, "Content Too Large")          \
+    XX(422, "Unprocessable Content")
+
+struct StatusEntry {
+    const char* reason;  // 原因短语, 未知状态码为nullptr
+    uint8_t reason_len;
+    const char* line;  // 预渲染的状态行: "HTTP/1.1 200 OK\r\n"
+    uint8_t line_len;
+};
+
+namespace detail {
+static constexpr int c_status_min = 100;
+static constexpr int c_status_max = 599;
+
+#define XX(num, name, string) code == num ? #string :
+#define YY(num, string) code == num ? string :
+constexpr const char* StatusReasonOf(int code) {
+    return RAPIDHTTP_OVERRIDE_STATUS_MAP(YY) HTTP_STATUS_MAP(XX)
+        RAPIDHTTP_EXTRA_STATUS_MAP(YY) nullptr;
+}
+#undef YY
+#undef XX
+
+#define XX(num, name, string) code == num ? "HTTP/1.1 " #num " " #string "\r\n" :
+#define YY(num, string) code == num ? "HTTP/1.1 " #num " " string "\r\n" :
+constexpr const char* StatusLineOf(int code) {
+    return RAPIDHTTP_OVERRIDE_STATUS_MAP(YY) HTTP_STATUS_MAP(XX)
+        RAPIDHTTP_EXTRA_STATUS_MAP(YY) nullptr;
+}
+#undef YY
+#undef XX
+
+constexpr StatusEntry MakeStatusEntry(int code) {
+    return StatusEntry{StatusReasonOf(code),
+                       (uint8_t)(StatusReasonOf(code) ? constLength(StatusReasonOf(code)) : 0),
+                       StatusLineOf(code),
+                       (uint8_t)(StatusLineOf(code) ? constLength(StatusLineOf(code)) : 0)};
+}
+
+template <typename Seq>
+struct StatusTable;
+
+template <size_t... I>
+struct StatusTable<IndexSequence<I...>> {
+    static constexpr StatusEntry entries[sizeof...(I)] = {MakeStatusEntry(c_status_min + I)...};
+};
+template <size_t... I>
+constexpr StatusEntry StatusTable<IndexSequence<I...>>::entries[sizeof...(I)];
+
+using StatusTableType = StatusTable<MakeIndexSequence<c_status_max - c_status_min + 1>::type>;
+}  // namespace detail
+
+/// 按状态码直接索引, 不在100~599之间时返回nullptr
+inline const StatusEntry* FindStatus(int code) noexcept {
+    unsigned index = (unsigned)(code - detail::c_status_min);
+    if (index > (unsigned)(detail::c_status_max - detail::c_status_min)) return nullptr;
+    return &detail::StatusTableType::entries[index];
+}
+
+/// 状态码的原因短语, 未知状态码返回nullptr
+inline const char* StatusReason(int code) noexcept {
+    const StatusEntry* entry = FindStatus(code);
+    return entry ? entry->reason : nullptr;
+}
+
+}  // namespace rapidhttp
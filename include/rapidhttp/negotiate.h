@@ -0,0 +1,302 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <initializer_list>
+
+#include "util.h"
+
+namespace rapidhttp {
+
+namespace detail {
+/// 定点数的q值, 1.000 => 1000, 不合法时返回-1
+inline int ParseQValue(const char* s, size_t len) noexcept {
+    if (!len || len > 5 || (s[0] != '0' && s[0] != '1')) return -1;
+    int q = (s[0] - '0') * 1000;
+    if (len == 1) return q;
+    if (s[1] != '.') return -1;
+    int scale = 100;
+    for (size_t i = 2; i < len; ++i, scale /= 10) {
+        unsigned d = (unsigned)(s[i] - '0');
+        if (d > 9) return -1;
+        q += d * scale;
+    }
+    return q > 1000 ? -1 : q;
+}
+
+/// 查找下一个参数分隔符';', 跳过引号内的部分, 没有时返回end
+inline const char* FindParamSeparator(const char* pos, const char* end) noexcept {
+    bool quoted = false;
+    for (; pos < end; ++pos) {
+        if (quoted) {
+            if (*pos == '\\' && pos + 1 < end)
+                ++pos;
+            else if (*pos == '"')
+                quoted = false;
+        } else if (*pos == '"') {
+            quoted = true;
+        } else if (*pos == ';') {
+            return pos;
+        }
+    }
+    return end;
+}
+
+/// 拆分带权重的元素 "text/html;level=1;q=0.5"
+// @token_end: 写入';'之前部分的结束位置
+// @returns: q值, 没有q参数时为1000, 不合法的q参数被忽略(同样为1000)
+inline int ParseWeightedElement(const char* first, const char* end,
+                                const char** token_end) noexcept {
+    const char* semi = FindParamSeparator(first, end);
+    const char* stop = semi;
+    while (stop > first && IsOWS(stop[-1])) --stop;
+    *token_end = stop;
+
+    int q = 1000;
+    while (semi < end) {
+        const char* param = semi + 1;
+        semi = FindParamSeparator(param, end);
+        const char* param_end = semi;
+        while (param < param_end && IsOWS(*param)) ++param;
+        if (param_end - param >= 2 && ToLower(param[0]) == 'q' &&
+            (param[1] == '=' || IsOWS(param[1]))) {
+            const char* value = param + 1;
+            while (value < param_end && (IsOWS(*value) || *value == '=')) ++value;
+            const char* value_end = param_end;
+            while (value_end > value && IsOWS(value_end[-1])) --value_end;
+            int value_q = ParseQValue(value, value_end - value);
+            if (value_q >= 0) q = value_q;
+            break;
+        }
+    }
+    return q;
+}
+
+}  // namespace detail
+
+/// 服务端提供的媒体类型列表, 构造时预先拆好type/subtype, 之后每个请求只解析一遍Accept
+// 列表按服务端的偏好排序, q值相同时选靠前的. 字符串必须是小写且在对象的生命周期内有效
+// (一般是字面量), 最多c_max_offers个.
+//
+//   static const MediaOffers c_offers{"application/json", "text/html"};
+//   int index = request.NegotiateMedia(c_offers);  // -1 => 406
+class MediaOffers {
+  public:
+    static const size_t c_max_offers = 32;
+
+    MediaOffers(std::initializer_list<const char*> offers) noexcept {
+        for (const char* offer : offers) {
+            if (count_ == c_max_offers) break;
+            Offer& o = offers_[count_++];
+            o.str = offer;
+            o.len = strlen(offer);
+            const char* slash = (const char*)memchr(offer, '/', o.len);
+            o.slash = slash ? slash - offer : o.len;
+        }
+    }
+
+    inline size_t Size() const noexcept { return count_; }
+    inline const char* Get(size_t index) const noexcept { return offers_[index].str; }
+
+    /// 按Accept的值选出最合适的offer
+    // @accept: nullptr表示没有Accept域, 此时任何类型都可接受
+    // @returns: offer的下标, 没有可接受的返回-1
+    inline int Negotiate(const char* accept, size_t len) const noexcept {
+        if (!count_) return -1;
+        if (!accept || !len) return 0;
+
+        // 每个offer匹配到的最精确的range: 2 type/subtype, 1 type/*, 0 */*
+        int8_t specificity[c_max_offers];
+        int16_t quality[c_max_offers];
+        Init(specificity, quality);
+        const char* pos = accept;
+        const char* last = accept + len;
+        const char *first, *end;
+        while (detail::NextListElement(pos, last, &first, &end))
+            Match(first, end, specificity, quality);
+        return Best(specificity, quality);
+    }
+
+    /// 同上, 参数是已经拆好的元素(如TRequest::GetFieldElements("accept")),
+    /// 多个Accept域等价于用','连接起来的一个域
+    template <typename Elements>
+    inline int Negotiate(Elements const& elements) const noexcept {
+        if (!count_) return -1;
+        int8_t specificity[c_max_offers];
+        int16_t quality[c_max_offers];
+        Init(specificity, quality);
+        bool empty = true;
+        for (auto const& element : elements) {
+            Match(element.data(), element.data() + element.size(), specificity, quality);
+            empty = false;
+        }
+        return empty ? 0 : Best(specificity, quality);
+    }
+
+  private:
+    inline void Init(int8_t* specificity, int16_t* quality) const noexcept {
+        for (size_t i = 0; i < count_; ++i) {
+            specificity[i] = -1;
+            quality[i] = 0;
+        }
+    }
+
+    // 一个media-range, 更新它能匹配的offer
+    inline void Match(const char* first, const char* end, int8_t* specificity,
+                      int16_t* quality) const noexcept {
+        const char* token_end;
+        int q = detail::ParseWeightedElement(first, end, &token_end);
+        const char* slash = (const char*)memchr(first, '/', token_end - first);
+        const char* type_end = slash ? slash : token_end;
+        const char* sub = slash ? slash + 1 : token_end;
+        size_t type_len = type_end - first;
+        size_t sub_len = token_end - sub;
+        bool any_type = type_len == 1 && *first == '*';
+        bool any_sub = !slash || (sub_len == 1 && *sub == '*');
+
+        for (size_t i = 0; i < count_; ++i) {
+            const Offer& o = offers_[i];
+            int8_t spec;
+            if (any_type) {
+                spec = 0;
+            } else if (!EqualsNoCase(first, type_len, o.str, o.slash)) {
+                continue;
+            } else if (any_sub) {
+                spec = 1;
+            } else if (o.slash < o.len &&
+                       EqualsNoCase(sub, sub_len, o.str + o.slash + 1, o.len - o.slash - 1)) {
+                spec = 2;
+            } else {
+                continue;
+            }
+            if (spec > specificity[i]) {
+                specificity[i] = spec;
+                quality[i] = q;
+            }
+        }
+    }
+
+    inline int Best(const int8_t* specificity, const int16_t* quality) const noexcept {
+        int best = -1;
+        for (size_t i = 0; i < count_; ++i)
+            if (specificity[i] >= 0 && quality[i] > 0 && (best < 0 || quality[i] > quality[best]))
+                best = (int)i;
+        return best;
+    }
+
+    struct Offer {
+        const char* str;
+        size_t len;
+        size_t slash;  // '/'的位置, 没有时等于len
+    };
+    Offer offers_[c_max_offers];
+    size_t count_{0};
+};
+
+/// 服务端支持的内容编码列表(如"br", "gzip", "identity"), 约定同MediaOffers
+class EncodingOffers {
+  public:
+    static const size_t c_max_offers = 32;
+
+    EncodingOffers(std::initializer_list<const char*> offers) noexcept {
+        for (const char* offer : offers) {
+            if (count_ == c_max_offers) break;
+            offers_[count_].str = offer;
+            offers_[count_].len = strlen(offer);
+            if (EqualsNoCase(offer, offers_[count_].len, "identity", 8)) identity_ = (int)count_;
+            ++count_;
+        }
+    }
+
+    inline size_t Size() const noexcept { return count_; }
+    inline const char* Get(size_t index) const noexcept { return offers_[index].str; }
+
+    /// 按Accept-Encoding的值选出最合适的编码
+    // @accept: nullptr表示没有Accept-Encoding域, 此时优先identity, 没有identity时选第一个
+    // 没被提到的identity默认可接受(除非"identity;q=0"或"*;q=0").
+    // @returns: offer的下标, 没有可接受的返回-1
+    inline int Negotiate(const char* accept, size_t len) const noexcept {
+        if (!count_) return -1;
+        if (!accept) return identity_ >= 0 ? identity_ : 0;
+
+        // 0: 未提到, 1: 由*匹配, 2: 显式列出
+        int8_t specificity[c_max_offers];
+        int16_t quality[c_max_offers];
+        Init(specificity, quality);
+        const char* pos = accept;
+        const char* last = accept + len;
+        const char *first, *end;
+        while (detail::NextListElement(pos, last, &first, &end))
+            Match(first, end, specificity, quality);
+        return Best(specificity, quality);
+    }
+
+    /// 同上, 参数是已经拆好的元素(如TRequest::GetFieldElements("accept-encoding")),
+    /// 表示Accept-Encoding域存在, 多个域等价于用','连接起来的一个域
+    template <typename Elements>
+    inline int Negotiate(Elements const& elements) const noexcept {
+        if (!count_) return -1;
+        int8_t specificity[c_max_offers];
+        int16_t quality[c_max_offers];
+        Init(specificity, quality);
+        for (auto const& element : elements)
+            Match(element.data(), element.data() + element.size(), specificity, quality);
+        return Best(specificity, quality);
+    }
+
+  private:
+    inline void Init(int8_t* specificity, int16_t* quality) const noexcept {
+        for (size_t i = 0; i < count_; ++i) {
+            specificity[i] = 0;
+            quality[i] = 0;
+        }
+    }
+
+    // 一个编码, 更新它能匹配的offer
+    inline void Match(const char* first, const char* end, int8_t* specificity,
+                      int16_t* quality) const noexcept {
+        const char* token_end;
+        int q = detail::ParseWeightedElement(first, end, &token_end);
+        size_t token_len = token_end - first;
+        bool any = token_len == 1 && *first == '*';
+        for (size_t i = 0; i < count_; ++i) {
+            int8_t spec;
+            if (any)
+                spec = 1;
+            else if (EqualsNoCase(first, token_len, offers_[i].str, offers_[i].len))
+                spec = 2;
+            else
+                continue;
+            if (spec > specificity[i]) {
+                specificity[i] = spec;
+                quality[i] = q;
+            }
+        }
+    }
+
+    inline int Best(int8_t* specificity, int16_t* quality) const noexcept {
+        if (identity_ >= 0 && specificity[identity_] == 0) {
+            // identity只有在被显式拒绝时才不可接受, 优先级最低
+            specificity[identity_] = 1;
+            quality[identity_] = 1;
+        }
+
+        int best = -1;
+        for (size_t i = 0; i < count_; ++i)
+            if (specificity[i] > 0 && quality[i] > 0 && (best < 0 || quality[i] > quality[best]))
+                best = (int)i;
+        return best;
+    }
+
+    struct Offer {
+        const char* str;
+        size_t len;
+    };
+    Offer offers_[c_max_offers];
+    size_t count_{0};
+    int identity_{-1};
+};
+
+}  // namespace rapidhttp
@@ -0,0 +1,217 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/uio.h>
+
+#include <algorithm>
+#include <new>
+
+#include "doc.h"
+#include "serialize_cursor.h"
+
+namespace rapidhttp {
+
+/// 输出缓冲块
+struct OutputBlock {
+    OutputBlock* next;
+    uint32_t rpos;      // 已发送的位置
+    uint32_t wpos;      // 已写入的位置
+    uint32_t capacity;  // data的大小
+    char data[1];
+
+    inline size_t Readable() const noexcept { return wpos - rpos; }
+    inline size_t Writable() const noexcept { return capacity - wpos; }
+};
+
+/// 输出缓冲块的对象池
+// 不是线程安全的, 一般每个IO线程一个(见ThreadLocal).
+class OutputBlockPool {
+  public:
+    static const size_t c_default_block_size = 16 * 1024;
+    static const size_t c_default_max_free = 64;
+
+    explicit OutputBlockPool(size_t block_size = c_default_block_size,
+                             size_t max_free = c_default_max_free) noexcept
+        : block_size_(block_size), max_free_(max_free) {}
+    OutputBlockPool(OutputBlockPool const&) = delete;
+    OutputBlockPool& operator=(OutputBlockPool const&) = delete;
+
+    ~OutputBlockPool() {
+        while (free_) {
+            OutputBlock* block = free_;
+            free_ = block->next;
+            free(block);
+        }
+    }
+
+    /// 当前线程的默认对象池
+    static OutputBlockPool& ThreadLocal() {
+        static thread_local OutputBlockPool pool;
+        return pool;
+    }
+
+    inline OutputBlock* Get() {
+        OutputBlock* block = free_;
+        if (block) {
+            free_ = block->next;
+            --free_count_;
+        } else {
+            block = (OutputBlock*)malloc(offsetof(OutputBlock, data) + block_size_);
+            if (!block) throw std::bad_alloc();
+            block->capacity = block_size_;
+        }
+        block->next = nullptr;
+        block->rpos = 0;
+        block->wpos = 0;
+        return block;
+    }
+
+    inline void Put(OutputBlock* block) noexcept {
+        if (free_count_ >= max_free_) {
+            free(block);
+            return;
+        }
+        block->next = free_;
+        free_ = block;
+        ++free_count_;
+    }
+
+    inline size_t BlockSize() const noexcept { return block_size_; }
+    inline size_t FreeBlocks() const noexcept { return free_count_; }
+
+  private:
+    size_t block_size_;
+    size_t max_free_;
+    size_t free_count_{0};
+    OutputBlock* free_{nullptr};
+};
+
+/// 输出缓冲链
+// 多个response依次追加进来, 小的response紧挨着打包进同一个缓冲块,
+// 整条链可以通过ToIovec一次writev发送. 缓冲块来自OutputBlockPool,
+// 发送完成后由Consume归还, 稳定状态下没有内存分配.
+// 对象池必须显式传入: OutputChain的所有操作(包括析构)都会访问对象池, 而对象池
+// 不是线程安全的, 所以链只能在使用这个对象池的线程中操作, 且不能比对象池活得久.
+// 链需要跨线程迁移时, 给它一个独立的对象池并保证同一时刻只有一个线程在操作.
+class OutputChain {
+  public:
+    explicit OutputChain(OutputBlockPool& pool) noexcept : pool_(pool) {}
+    OutputChain(OutputChain const&) = delete;
+    OutputChain& operator=(OutputChain const&) = delete;
+    ~OutputChain() { Clear(); }
+
+    /// 追加序列化后的document
+    // @returns: document未初始化时返回false
+    template <typename StringT>
+    inline bool Append(const TDocument<StringT>& doc) {
+        size_t bytes = doc.ByteSize();
+        if (!bytes) return false;
+
+        if (tail_ && tail_->Writable() >= bytes) {
+            doc.Serialize(tail_->data + tail_->wpos, bytes);
+            tail_->wpos += bytes;
+            bytes_ += bytes;
+            return true;
+        }
+
+        // 放不进当前块时, 写满当前块后再跨块继续
+        TSerializeCursor<StringT> cursor(doc);
+        while (!cursor.Done()) {
+            OutputBlock* block = WritableBlock();
+            size_t n = cursor.Serialize(block->data + block->wpos, block->Writable());
+            block->wpos += n;
+            bytes_ += n;
+        }
+        return true;
+    }
+
+    /// 追加原始数据
+    inline void Append(const char* data, size_t len) {
+        while (len) {
+            OutputBlock* block = WritableBlock();
+            size_t n = std::min(len, block->Writable());
+            memcpy(block->data + block->wpos, data, n);
+            block->wpos += n;
+            bytes_ += n;
+            data += n;
+            len -= n;
+        }
+    }
+
+    /// 待发送的数据填入iovec, 可直接交给writev
+    // @returns: 使用的iovec数量, n不足时只填前n个
+    inline size_t ToIovec(struct iovec* out, size_t n) const noexcept {
+        size_t count = 0;
+        for (OutputBlock* block = head_; block && count < n; block = block->next) {
+            if (!block->Readable()) continue;
+            out[count].iov_base = block->data + block->rpos;
+            out[count].iov_len = block->Readable();
+            ++count;
+        }
+        return count;
+    }
+
+    /// 标记已发送的字节数, 发送完的缓冲块归还对象池
+    inline void Consume(size_t bytes) noexcept {
+        bytes = std::min(bytes, bytes_);
+        bytes_ -= bytes;
+        while (head_) {
+            size_t n = std::min(bytes, head_->Readable());
+            head_->rpos += n;
+            bytes -= n;
+            if (head_->Readable()) break;
+            // 最后一块留着继续写入
+            if (head_ == tail_) {
+                head_->rpos = head_->wpos = 0;
+                break;
+            }
+            OutputBlock* block = head_;
+            head_ = block->next;
+            pool_.Put(block);
+        }
+    }
+
+    /// 待发送的字节数
+    inline size_t ByteSize() const noexcept { return bytes_; }
+    inline bool Empty() const noexcept { return !bytes_; }
+
+    /// 缓冲块数量, 即ToIovec最多需要的iovec数量
+    inline size_t BlockCount() const noexcept {
+        size_t count = 0;
+        for (OutputBlock* block = head_; block; block = block->next) ++count;
+        return count;
+    }
+
+    /// 丢弃所有数据, 缓冲块全部归还对象池
+    inline void Clear() noexcept {
+        while (head_) {
+            OutputBlock* block = head_;
+            head_ = block->next;
+            pool_.Put(block);
+        }
+        tail_ = nullptr;
+        bytes_ = 0;
+    }
+
+  private:
+    inline OutputBlock* WritableBlock() {
+        if (tail_ && tail_->Writable()) return tail_;
+        OutputBlock* block = pool_.Get();
+        if (tail_)
+            tail_->next = block;
+        else
+            head_ = block;
+        tail_ = block;
+        return block;
+    }
+
+  private:
+    OutputBlockPool& pool_;
+    OutputBlock* head_{nullptr};
+    OutputBlock* tail_{nullptr};
+    size_t bytes_{0};
+};
+
+}  // namespace rapidhttp
@@ -9,10 +9,15 @@
 #include "cmake_config.h"
 #include "constants.h"
 #include "error_code.h"
+#include "field_set.h"
 #include "layer.hpp"
+#include "parser_features.h"
 #include "request.h"
+#include "request_line.h"
 #include "response.h"
+#include "string_traits.h"
 #include "stringref.h"
+#include "util.h"
 
 namespace rapidhttp {
 
@@ -21,8 +26,43 @@ namespace rapidhttp {
 //     Response,
 // };
 
+/// TParser默认的解析引擎: http-parser
+// 消息开始时先尝试请求行的快速路径, 见detail::FastRequestLine
+struct HttpParserEngine {
+    inline void Init(http_parser *parser, http_parser_type type) { http_parser_init(parser, type); }
+    inline size_t Execute(http_parser *parser, const http_parser_settings *settings,
+                          const char *data, size_t len) {
+        size_t n = 0;
+        if (parser->state == s_start_req) {
+            n = detail::FastRequestLine(parser, settings, data, len);
+            if (n && (n == len || HTTP_PARSER_ERRNO(parser) != HPE_OK)) return n;
+        }
+        return n + http_parser_execute(parser, settings, data + n, len - n);
+    }
+
+    /// 见TParser::ExpectedBytes, 分块时至少还有块尾的CRLF和最后一块"0\r\n\r\n"
+    inline uint64_t ExpectedBytes(const http_parser *parser) const noexcept {
+        switch (parser->state) {
+            case s_body_identity:
+                return parser->content_length;
+            case s_chunk_data:
+                return parser->content_length + 2 + 5;
+            case s_chunk_data_almost_done:
+                return 2 + 5;
+            case s_chunk_data_done:
+                return 1 + 5;
+            default:
+                return 1;
+        }
+    }
+};
+
 // Http Header document class.
-template <typename StringT>
+// @Fields: 需要保留的域, 默认全部保留, 见RAPIDHTTP_FIELD_SET
+// @Features: 启用的解析功能, 默认全部启用, 见TParserFeatures
+// @Engine: 驱动回调的解析引擎, 默认是http-parser, 见DfaEngine
+template <typename StringT, typename Fields = AllFields, typename Features = AllFeatures,
+          typename Engine = HttpParserEngine>
 class TParser {
   public:
     using string_t = StringT;
@@ -52,6 +92,48 @@ class TParser {
     /// 是否解析成功
     inline bool ParseDone() const noexcept;
 
+    /// 还需要多少字节才能继续解析或者完成当前消息
+    // 有Content-Length的body是剩余的长度, 正好完成消息; 在chunk中是完成消息所需
+    // 字节数的下限(当前块的剩余部分, 块尾的CRLF和最后一块); 其它情况(头部, 块大小,
+    // 读到链接断开为止的body)无法确定, 返回1. 消息已经解析完成或出错时返回0.
+    // 可以用来决定recv的大小, 是否使用MSG_WAITALL或splice.
+    inline uint64_t ExpectedBytes() const noexcept {
+        if (ParseDone() || ParseError()) return 0;
+        return engine_.ExpectedBytes(&parser_);
+    }
+
+    /// 预取解析状态, 之后马上要解析时使用, 见ParseBatch
+    inline void Prefetch() const noexcept { detail::Prefetch(this, sizeof(*this), true); }
+
+    /// 当前消息的头部是否已经解析完成
+    inline bool HeadersDone() const noexcept { return headers_done_; }
+
+    /// ------------------- body直接放置 ---------------------
+    /// 注册body的目标缓冲区(预先分配的内存, mmap的文件区域, 注册过的IO缓冲区...)
+    // 只用于有Content-Length的body, 在头部解析完成之后, 消息完成之前调用.
+    // 已经随头部一起解析到的body会拷贝到开头, 之后的body不再存入document:
+    // 调用方直接把数据recv到GetBodyDestination() + BodyPlaced(), 最多ExpectedBytes()
+    // 字节, 再调用CommitBody通知解析器; 仍然通过PartailParse传入的body会被拷贝进来.
+    // @buf: 至少容纳整个body, 在消息完成之前必须有效
+    // @returns: 不满足条件时返回false, body照常存入document
+    inline bool SetBodyDestination(char *buf, size_t size);
+
+    /// 调用方已经直接写入了n字节body
+    // @returns: 接受的字节数, 超过ExpectedBytes()的部分不属于这个消息, 不会被接受
+    inline size_t CommitBody(size_t n);
+
+    inline char *GetBodyDestination() const noexcept { return body_dest_; }
+    /// 已经放置到目标缓冲区的body长度
+    inline size_t BodyPlaced() const noexcept { return body_placed_; }
+
+    /// 头部预扫描模式, 默认关闭
+    // 开启后先扫描头部结束的空行, 头部不完整时不进入状态机, PartailParse直接返回0,
+    // 调用方保留这些数据, 收到更多数据后连同之前的数据一起再传入, 扫描从上次停下的
+    // 位置继续. 头部完整后一次解析完, 不会有被缓冲区切断的回调, 借用型StringT的
+    // 头部也就不需要拼接分片. body部分不受影响.
+    // 没有头部的HTTP/0.9请求要等到PartailParseEof才会被解析.
+    inline void SetHeaderPrescan(bool on) noexcept { prescan_ = on; }
+
     /// 重置解析流状态
     // 同时清除解析流状态和已解析成功的数据状态
     inline void Reset();
@@ -70,8 +152,12 @@ class TParser {
     template <typename OStringT>
     TResponse<OStringT> &&StealResponse();
 
-    inline bool IsRequest() const noexcept { return doc_.IsRequest(); }
-    inline bool IsResponse() const noexcept { return doc_.IsResponse(); }
+    inline bool IsRequest() const noexcept {
+        return !Features::Has(kFeatureResponse) || doc_.IsRequest();
+    }
+    inline bool IsResponse() const noexcept {
+        return Features::Has(kFeatureResponse) && doc_.IsResponse();
+    }
 
   private:
     inline bool CheckMethod() const noexcept;
@@ -99,6 +185,12 @@ class TParser {
     inline int OnHeaderField(http_parser *parser, const char *at, size_t length);
     inline int OnHeaderValue(http_parser *parser, const char *at, size_t length);
     inline int OnBody(http_parser *parser, const char *at, size_t length);
+
+    // 把缓存的一对key/value加入document
+    inline void EmplaceField();
+
+    // 遇到被关闭的功能, 结束解析
+    inline int Disabled();
 #endif
 
   private:
@@ -112,29 +204,49 @@ class TParser {
 #else
     struct http_parser parser_;
     struct http_parser_settings settings_;
+    Engine engine_;
 #endif
 
-    int kv_state_{0};
+    bool prescan_{false};
+    bool headers_done_{false};  // 当前消息的头部已经解析完
+    size_t prescan_pos_{0};     // 已经扫描过, 没有找到空行的长度
+
+    char *body_dest_{nullptr};  // body直接放置的目标缓冲区
+    size_t body_placed_{0};
+
+    int kv_state_{0};  // 0: 正在读key, 1: 正在读value, 2: 正在跳过不关心的域
+    bool value_line_done_{false};  // 当前域值的这一行已经结束, 再有值就是折行
+    const char *parse_begin_{nullptr};  // 当前PartailParse的输入缓冲区
     string_t callback_header_key_cache_;
     string_t callback_header_value_cache_;
 
-    template <typename T>
+    // 不连续分片的拼接区, 只有string_view这类借用型StringT会用到.
+    // 解析结果可能引用这里的数据, 所以在Reset之前一直有效.
+    FragmentStore fragments_;
+
+    template <typename T, typename F, typename E, typename G>
     friend class TParser;
 };
 
-template <class StringT>
-struct TRequestParser : public TParser<StringT> {
-    using base_type = TParser<StringT>;
+template <class StringT, class Fields = AllFields, class Features = AllFeatures,
+          class Engine = HttpParserEngine>
+struct TRequestParser : public TParser<StringT, Fields, Features, Engine> {
+    using base_type = TParser<StringT, Fields, Features, Engine>;
     inline TRequestParser() : base_type(HTTP_REQUEST) {}
 };
-template <class StringT>
-struct TResponseParser : public TParser<StringT> {
-    using base_type = TParser<StringT>;
+template <class StringT, class Fields = AllFields, class Features = AllFeatures,
+          class Engine = HttpParserEngine>
+struct TResponseParser : public TParser<StringT, Fields, Features, Engine> {
+    using base_type = TParser<StringT, Fields, Features, Engine>;
     inline TResponseParser() : base_type(HTTP_RESPONSE) {}
 };
 
 using RequestParser = TRequestParser<std::string>;
 using ResponseParser = TResponseParser<std::string>;
+#if RAPIDHTTP_HAS_STRING_VIEW
+using ViewRequestParser = TRequestParser<std::string_view>;
+using ViewResponseParser = TResponseParser<std::string_view>;
+#endif
 
 }  // namespace rapidhttp
 
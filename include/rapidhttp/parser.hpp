@@ -1,5 +1,6 @@
 #pragma once
 #include <stdio.h>
+#include <string.h>
 
 #include <algorithm>
 
@@ -8,8 +9,9 @@
 
 namespace rapidhttp {
 
-template <typename StringT>
-inline TParser<StringT>::TParser(http_parser_type type) : doc_(type) {
+template <typename StringT, typename Fields, typename Features, typename Engine>
+inline TParser<StringT, Fields, Features, Engine>::TParser(http_parser_type type)
+    : doc_(Features::Has(kFeatureResponse) ? type : HTTP_REQUEST) {
     Reset();
 #if USE_PICO
 #else
@@ -30,67 +32,120 @@ inline TParser<StringT>::TParser(http_parser_type type) : doc_(type) {
 // @len: 缓冲区长度
 // @returns：解析完成返回error_code=0, 解析一半返回error_code=1,
 // 解析失败返回其他错误码.
-template <typename StringT>
-inline size_t TParser<StringT>::PartailParse(std::string const& buf) {
+template <typename StringT, typename Fields, typename Features, typename Engine>
+inline size_t TParser<StringT, Fields, Features, Engine>::PartailParse(std::string const& buf) {
     return PartailParse(buf.c_str(), buf.size());
 }
 
 #if USE_PICO
 #else
-template <typename StringT>
-inline size_t TParser<StringT>::PartailParse(const char *buf_ref, size_t len) {
+template <typename StringT, typename Fields, typename Features, typename Engine>
+inline size_t TParser<StringT, Fields, Features, Engine>::PartailParse(const char *buf_ref,
+                                                                       size_t len) {
     if (ParseDone() || ParseError()) Reset();
 
-    size_t parsed = http_parser_execute(&parser_, &settings_, buf_ref, len);
-    if (parser_.http_errno) {
+    if (prescan_ && !headers_done_ && len) {
+        if (prescan_pos_ > len) prescan_pos_ = 0;
+        // 超过头部长度上限时交给状态机报错
+        if (!detail::FindHeaderEnd(buf_ref, buf_ref + prescan_pos_, buf_ref + len) &&
+            len <= max_header_size) {
+            prescan_pos_ = len;
+            return 0;
+        }
+        prescan_pos_ = 0;
+    }
+
+    parse_begin_ = buf_ref;
+    size_t parsed = engine_.Execute(&parser_, &settings_, buf_ref, len);
+    doc_.InvalidateCache(document_type::kDirtyAll);
+    if (!Features::Has(kFeatureObsFold) && kv_state_ == 0 &&
+        (parser_.state == s_header_value_discard_ws ||
+         parser_.state == s_header_value_discard_ws_almost_done ||
+         parser_.state == s_header_value_discard_lws) &&
+        detail::LineEndedBefore(buf_ref, buf_ref + parsed)) {
+        // 输入结束在空值之后的换行或折行的空白中, 下次再收到值就是折行
+        value_line_done_ = true;
+    }
+    if (parser_.http_errno && !ec_) {
         // TODO: support pause
         ec_ = MakeParseErrorCode(parser_.http_errno);
     }
     return parsed;
 }
-template <typename StringT>
-inline bool TParser<StringT>::PartailParseEof() {
+template <typename StringT, typename Fields, typename Features, typename Engine>
+inline bool TParser<StringT, Fields, Features, Engine>::PartailParseEof() {
     if (ParseDone() || ParseError()) return false;
 
     PartailParse("", 0);
     return ParseDone();
 }
-template <typename StringT>
-inline bool TParser<StringT>::ParseDone() const noexcept {
+template <typename StringT, typename Fields, typename Features, typename Engine>
+inline bool TParser<StringT, Fields, Features, Engine>::SetBodyDestination(char *buf, size_t size) {
+    if (!headers_done_ || ParseDone() || ParseError() || body_dest_) return false;
+    if (!(parser_.flags & F_CONTENTLENGTH) || (parser_.flags & F_CHUNKED)) return false;
+    size_t received = doc_.body_.size();
+    if (size < received || size - received < ExpectedBytes()) return false;
+
+    memcpy(buf, doc_.body_.data(), received);
+    StringTraits<string_t>::clear(doc_.body_);
+    body_dest_ = buf;
+    body_placed_ = received;
+    return true;
+}
+template <typename StringT, typename Fields, typename Features, typename Engine>
+inline size_t TParser<StringT, Fields, Features, Engine>::CommitBody(size_t n) {
+    if (!body_dest_ || ParseDone() || ParseError()) return 0;
+    if (n > ExpectedBytes()) n = (size_t)ExpectedBytes();
+    return PartailParse(body_dest_ + body_placed_, n);
+}
+template <typename StringT, typename Fields, typename Features, typename Engine>
+inline bool TParser<StringT, Fields, Features, Engine>::ParseDone() const noexcept {
     return parse_done_;
 }
 
-template <typename StringT>
-inline int TParser<StringT>::sOnHeadersComplete(http_parser *parser) {
+template <typename StringT, typename Fields, typename Features, typename Engine>
+inline int TParser<StringT, Fields, Features, Engine>::sOnHeadersComplete(http_parser *parser) {
     return ((TParser *)parser->data)->OnHeadersComplete(parser);
 }
-template <typename StringT>
-inline int TParser<StringT>::sOnMessageComplete(http_parser *parser) {
+template <typename StringT, typename Fields, typename Features, typename Engine>
+inline int TParser<StringT, Fields, Features, Engine>::sOnMessageComplete(http_parser *parser) {
     return ((TParser *)parser->data)->OnMessageComplete(parser);
 }
-template <typename StringT>
-inline int TParser<StringT>::sOnUrl(http_parser *parser, const char *at, size_t length) {
+template <typename StringT, typename Fields, typename Features, typename Engine>
+inline int TParser<StringT, Fields, Features, Engine>::sOnUrl(http_parser *parser, const char *at,
+                                                              size_t length) {
     return ((TParser *)parser->data)->OnUrl(parser, at, length);
 }
-template <typename StringT>
-inline int TParser<StringT>::sOnStatus(http_parser *parser, const char *at, size_t length) {
+template <typename StringT, typename Fields, typename Features, typename Engine>
+inline int TParser<StringT, Fields, Features, Engine>::
+    sOnStatus(http_parser *parser, const char *at, size_t length) {
     return ((TParser *)parser->data)->OnStatus(parser, at, length);
 }
-template <typename StringT>
-inline int TParser<StringT>::sOnHeaderField(http_parser *parser, const char *at, size_t length) {
+template <typename StringT, typename Fields, typename Features, typename Engine>
+inline int TParser<StringT, Fields, Features, Engine>::
+    sOnHeaderField(http_parser *parser, const char *at, size_t length) {
     return ((TParser *)parser->data)->OnHeaderField(parser, at, length);
 }
-template <typename StringT>
-inline int TParser<StringT>::sOnHeaderValue(http_parser *parser, const char *at, size_t length) {
+template <typename StringT, typename Fields, typename Features, typename Engine>
+inline int TParser<StringT, Fields, Features, Engine>::
+    sOnHeaderValue(http_parser *parser, const char *at, size_t length) {
     return ((TParser *)parser->data)->OnHeaderValue(parser, at, length);
 }
-template <typename StringT>
-inline int TParser<StringT>::sOnBody(http_parser *parser, const char *at, size_t length) {
+template <typename StringT, typename Fields, typename Features, typename Engine>
+inline int TParser<StringT, Fields, Features, Engine>::sOnBody(http_parser *parser, const char *at,
+                                                               size_t length) {
     return ((TParser *)parser->data)->OnBody(parser, at, length);
 }
 
-template <typename StringT>
-inline int TParser<StringT>::OnHeadersComplete(http_parser *parser) {
+template <typename StringT, typename Fields, typename Features, typename Engine>
+inline int TParser<StringT, Fields, Features, Engine>::OnHeadersComplete(http_parser *parser) {
+    if (!Features::Has(kFeatureChunked) && (parser->flags & F_CHUNKED)) return Disabled();
+    if (!Features::Has(kFeatureUpgrade) && parser->upgrade) {
+        // CONNECT之后是隧道, 没法当作普通的消息; Upgrade则忽略, 按普通的消息继续解析
+        if (IsRequest() && parser->method == HTTP_CONNECT) return Disabled();
+        parser->upgrade = 0;
+    }
+
     if (IsRequest())
         // request_method_ = http_method_str((http_method)parser->method);
         // request_method_ = (http_method)parser->method;
@@ -100,69 +155,136 @@ inline int TParser<StringT>::OnHeadersComplete(http_parser *parser) {
         doc_.SetStatusCode(parser->status_code);
     doc_.SetMajor(parser->http_major);
     doc_.SetMinor(parser->http_minor);
-    if (kv_state_ == 1) {
-        // doc_.SetField(std::move(callback_header_key_cache_),
-        //               std::move(callback_header_value_cache_));
-        doc_.header_fields_.emplace_back(std::move(callback_header_key_cache_),
-                                         std::move(callback_header_value_cache_));
-        kv_state_ = 0;
+    if (kv_state_ == 1) EmplaceField();
+    headers_done_ = true;
+
+    // http-parser已经算好的结果直接保存下来
+    HeaderInfo &info = doc_.header_info_;
+    if (parser->flags & F_CONTENTLENGTH) {
+        info.content_length = parser->content_length;
+        info.flags |= HeaderInfo::kHasContentLength;
     }
+    if (parser->flags & F_CHUNKED) info.flags |= HeaderInfo::kChunked;
+    if (http_should_keep_alive(parser)) info.flags |= HeaderInfo::kKeepAlive;
+    if (Features::Has(kFeatureUpgrade) && (parser->flags & F_UPGRADE) &&
+        (parser->flags & F_CONNECTION_UPGRADE))
+        info.flags |= HeaderInfo::kUpgrade;
+    info.valid = true;
     return 0;
 }
-template <typename StringT>
-inline int TParser<StringT>::OnMessageComplete(http_parser *parser) {
+template <typename StringT, typename Fields, typename Features, typename Engine>
+inline void TParser<StringT, Fields, Features, Engine>::EmplaceField() {
+    // doc_.SetField(std::move(callback_header_key_cache_),
+    //               std::move(callback_header_value_cache_));
+    doc_.header_fields_.emplace_back(std::move(callback_header_key_cache_),
+                                     std::move(callback_header_value_cache_));
+    StringTraits<string_t>::clear(callback_header_key_cache_);
+    StringTraits<string_t>::clear(callback_header_value_cache_);
+    kv_state_ = 0;
+
+    auto const &kv = doc_.header_fields_.back();
+    doc_.header_info_.OnExtraField(kv.first.data(), kv.first.size(), kv.second.data(),
+                                   kv.second.size(), doc_.header_fields_.size() - 1);
+}
+template <typename StringT, typename Fields, typename Features, typename Engine>
+inline int TParser<StringT, Fields, Features, Engine>::Disabled() {
+    ec_ = MakeErrorCode(eErrorCode::feature_disabled);
+    return -1;
+}
+template <typename StringT, typename Fields, typename Features, typename Engine>
+inline int TParser<StringT, Fields, Features, Engine>::OnMessageComplete(http_parser *parser) {
     parse_done_ = true;
     return 0;
 }
-template <typename StringT>
-inline int TParser<StringT>::OnUrl(http_parser *parser, const char *at, size_t length) {
-    doc_.uri_or_status_.append(at, length);
+template <typename StringT, typename Fields, typename Features, typename Engine>
+inline int TParser<StringT, Fields, Features, Engine>::OnUrl(http_parser *parser, const char *at,
+                                                             size_t length) {
+    // 请求行在uri之后直接结束, 是HTTP/0.9
+    if (!Features::Has(kFeatureHttp09) && parser->http_major == 0 && parser->http_minor == 9)
+        return Disabled();
+    doc_.url_state_ = 0;
+    StringTraits<string_t>::append(doc_.uri_or_status_, at, length, fragments_);
     return 0;
 }
-template <typename StringT>
-inline int TParser<StringT>::OnStatus(http_parser *parser, const char *at, size_t length) {
-    doc_.uri_or_status_.append(at, length);
+template <typename StringT, typename Fields, typename Features, typename Engine>
+inline int TParser<StringT, Fields, Features, Engine>::OnStatus(http_parser *parser, const char *at,
+                                                                size_t length) {
+    StringTraits<string_t>::append(doc_.uri_or_status_, at, length, fragments_);
     return 0;
 }
-template <typename StringT>
-inline int TParser<StringT>::OnHeaderField(http_parser *parser, const char *at, size_t length) {
-    if (kv_state_ == 1) {
-        // doc_.SetField(std::move(callback_header_key_cache_),
-        //               std::move(callback_header_value_cache_));
-        doc_.header_fields_.emplace_back(std::move(callback_header_key_cache_),
-                                         std::move(callback_header_value_cache_));
+template <typename StringT, typename Fields, typename Features, typename Engine>
+inline int TParser<StringT, Fields, Features, Engine>::
+    OnHeaderField(http_parser *parser, const char *at, size_t length) {
+    if (kv_state_ == 1)
+        EmplaceField();
+    else if (kv_state_ == 2)
         kv_state_ = 0;
-    }
+    value_line_done_ = false;
 
-    callback_header_key_cache_.append(at, length);
+    StringTraits<string_t>::append(callback_header_key_cache_, at, length, fragments_);
     return 0;
 }
-template <typename StringT>
-inline int TParser<StringT>::OnHeaderValue(http_parser *parser, const char *at, size_t length) {
-    kv_state_ = 1;
-    callback_header_value_cache_.append(at, length);
+template <typename StringT, typename Fields, typename Features, typename Engine>
+inline int TParser<StringT, Fields, Features, Engine>::
+    OnHeaderValue(http_parser *parser, const char *at, size_t length) {
+    if (!Features::Has(kFeatureObsFold)) {
+        // 值在行尾结束后没有开始新的域又收到值, 说明是折行.
+        // 空值在开始下一个域时也会回调一次长度为0的值, 不算折行.
+        if (value_line_done_ && length) return Disabled();
+        // 空值之后的折行: 值的第一段之前的空白中有换行
+        if (kv_state_ == 0 && length && detail::LineEndedBefore(parse_begin_, at))
+            return Disabled();
+        value_line_done_ = parser->state == s_header_almost_done;
+    }
+    if (kv_state_ == 0) {
+        // key已经完整, 不关心的域只丢弃不保存
+        if (!Fields::c_all && !Fields::Contains(callback_header_key_cache_.data(),
+                                                callback_header_key_cache_.size())) {
+            StringTraits<string_t>::clear(callback_header_key_cache_);
+            kv_state_ = 2;
+            return 0;
+        }
+        kv_state_ = 1;
+    } else if (kv_state_ == 2) {
+        return 0;
+    }
+    StringTraits<string_t>::append(callback_header_value_cache_, at, length, fragments_);
     return 0;
 }
-template <typename StringT>
-inline int TParser<StringT>::OnBody(http_parser *parser, const char *at, size_t length) {
-    doc_.body_.append(at, length);
+template <typename StringT, typename Fields, typename Features, typename Engine>
+inline int TParser<StringT, Fields, Features, Engine>::OnBody(http_parser *parser, const char *at,
+                                                              size_t length) {
+    if (body_dest_) {
+        // CommitBody时数据已经在目标位置上了
+        char *dest = body_dest_ + body_placed_;
+        if (at != dest) memcpy(dest, at, length);
+        body_placed_ += length;
+        return 0;
+    }
+    StringTraits<string_t>::append(doc_.body_, at, length, fragments_);
     return 0;
 }
 #endif
 
-template <typename StringT>
-inline void TParser<StringT>::Reset() {
+template <typename StringT, typename Fields, typename Features, typename Engine>
+inline void TParser<StringT, Fields, Features, Engine>::Reset() {
 #if USE_PICO
 #else
-    http_parser_init(&parser_, IsRequest() ? HTTP_REQUEST : HTTP_RESPONSE);
+    engine_.Init(&parser_, IsRequest() ? HTTP_REQUEST : HTTP_RESPONSE);
     parser_.data = this;
 #endif
     doc_.Reset();
     parse_done_ = false;
     ec_ = std::error_code();
+    headers_done_ = false;
+    prescan_pos_ = 0;
+    body_dest_ = nullptr;
+    body_placed_ = 0;
     kv_state_ = 0;
-    callback_header_key_cache_.clear();
-    callback_header_value_cache_.clear();
+    value_line_done_ = false;
+    StringTraits<string_t>::clear(callback_header_key_cache_);
+    StringTraits<string_t>::clear(callback_header_value_cache_);
+    fragments_.clear();
     // major_ = 1;
     // minor_ = 1;
     // //   request_method_.clear();
@@ -175,35 +297,37 @@ inline void TParser<StringT>::Reset() {
 }
 
 // 返回解析错误码
-template <typename StringT>
-inline std::error_code TParser<StringT>::ParseError() const noexcept {
+template <typename StringT, typename Fields, typename Features, typename Engine>
+inline std::error_code TParser<StringT, Fields, Features, Engine>::ParseError() const noexcept {
     return ec_;
 }
 
-template <typename StringT>
-inline typename TParser<StringT>::request_t&& TParser<StringT>::StealRequest() {
+template <typename StringT, typename Fields, typename Features, typename Engine>
+inline typename TParser<StringT, Fields, Features, Engine>::request_t &&
+TParser<StringT, Fields, Features, Engine>::StealRequest() {
     // return request_t(request_method_, std::move(request_uri_), std::move(header_fields_),
     //                  std::move(body_), major_, minor_);
     return (request_t&&)std::move(doc_);
 }
-template <typename StringT>
-inline typename TParser<StringT>::response_t&& TParser<StringT>::StealResponse() {
+template <typename StringT, typename Fields, typename Features, typename Engine>
+inline typename TParser<StringT, Fields, Features, Engine>::response_t &&
+TParser<StringT, Fields, Features, Engine>::StealResponse() {
     // return response_t(response_status_code_, std::move(response_status_),
     // std::move(header_fields_),
     //                   std::move(body_), major_, minor_);
     return (response_t&&)std::move(doc_);
 }
-template <typename StringT>
+template <typename StringT, typename Fields, typename Features, typename Engine>
 template <typename OStringT>
-inline TRequest<OStringT>&& TParser<StringT>::StealRequest() {
+inline TRequest<OStringT>&& TParser<StringT, Fields, Features, Engine>::StealRequest() {
     // return TRequest<OStringT>(request_method_, std::move(request_uri_),
     // std::move(header_fields_),
     //                           std::move(body_), major_, minor_);
     return (request_t&&)std::move(doc_);
 }
-template <typename StringT>
+template <typename StringT, typename Fields, typename Features, typename Engine>
 template <typename OStringT>
-inline TResponse<OStringT>&& TParser<StringT>::StealResponse() {
+inline TResponse<OStringT>&& TParser<StringT, Fields, Features, Engine>::StealResponse() {
     // return TResponse<OStringT>(response_status_code_, std::move(response_status_),
     //                            std::move(header_fields_), std::move(body_), major_, minor_);
     return (response_t&&)std::move(doc_);
@@ -212,5 +336,8 @@ inline TResponse<OStringT>&& TParser<StringT>::StealResponse() {
 
 typedef TParser<std::string> Parser;
 typedef TParser<StringRef> RefParser;
+#if RAPIDHTTP_HAS_STRING_VIEW
+typedef TParser<std::string_view> ViewParser;
+#endif
 
 }  // namespace rapidhttp
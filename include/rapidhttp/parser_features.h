@@ -0,0 +1,27 @@
+#pragma once
+
+namespace rapidhttp {
+
+/// TParser的可选功能
+enum eParserFeature : unsigned {
+    kFeatureResponse = 1 << 0,  // 解析response, 关闭后只能解析request
+    kFeatureChunked = 1 << 1,   // Transfer-Encoding: chunked
+    kFeatureUpgrade = 1 << 2,   // 关闭后CONNECT被拒绝, Upgrade域被当作普通的域
+    kFeatureObsFold = 1 << 3,   // 域值的折行(obs-fold, RFC 7230 3.2.4)
+    kFeatureHttp09 = 1 << 4,    // 没有版本号的HTTP/0.9 request
+    kAllFeatures = (1 << 5) - 1,
+};
+
+/// 编译期确定的功能集合, 作为TParser的第三个模板参数
+// 关闭的功能在TParser中对应的代码被编译期裁掉, 遇到需要这些功能的消息时
+// 在进入http-parser对应的分支之前就以eErrorCode::feature_disabled结束解析.
+template <unsigned Mask>
+struct TParserFeatures {
+    static constexpr bool Has(unsigned feature) noexcept { return (Mask & feature) == feature; }
+};
+
+using AllFeatures = TParserFeatures<kAllFeatures>;
+// 常见的只处理request, 不做协议升级的服务
+using RequestFeatures = TParserFeatures<kFeatureChunked>;
+
+}  // namespace rapidhttp
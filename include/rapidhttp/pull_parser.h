@@ -0,0 +1,267 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <string>
+#include <system_error>
+#include <utility>
+
+#include "error_code.h"
+#include "layer.hpp"
+#include "sax_parser.h"
+#include "stringref.h"
+
+namespace rapidhttp {
+
+/// 拉取式解析得到的一个token
+struct PullToken {
+    enum eType {
+        kNeedMore,         // 输入已经全部消耗, 需要Feed更多数据
+        kRequestLine,      // method, version, first: uri
+        kStatusLine,       // status_code, version, first: reason
+        kHeader,           // first: name, second: value
+        kHeadersComplete,  // 头部结束, 之后是body(如果有的话)
+        kBody,             // first: 一段body, chunked时已经去掉了分块格式
+        kMessageComplete,  // 一个完整的消息结束, 之后可以继续解析下一个消息
+        kError,            // 解析错误, 见PullParser::ParseError()
+    };
+
+    eType type{kNeedMore};
+    http_method method{HTTP_DELETE};
+    int status_code{0};
+    uint8_t major{0};
+    uint8_t minor{0};
+    StringRef first;
+    StringRef second;
+};
+
+/// 拉取式解析器
+// 与TParser一样由http-parser驱动增量解析, 区别是不通过回调交付结果,
+// 每次Next()只前进到下一个token就暂停(http_parser_pause), 调用方按需拉取:
+//
+//   parser.Feed(buf, len);
+//   for (;;) {
+//       PullToken const& token = parser.Next();
+//       if (token.type == PullToken::kNeedMore) break;   // 去读更多数据
+//       ...
+//   }
+//
+// token中的StringRef指向Feed进来的缓冲区(被缓冲区边界切断的值除外, 那些会
+// 拼接到解析器内部), 在下一次Next()或Feed()之前有效.
+// 返回kNeedMore时输入已经全部消耗, 调用方可以释放或复用这块缓冲区.
+//
+// 和TParser共用的是http-parser状态机本身, 而不是同一个解析器实例: PullParser
+// 有自己的http_parser和待拼接的值, 不能在一个消息的中途从TParser切换过来或者
+// 切换回去, 只能在消息边界(kMessageComplete之后)换用另一个解析器.
+// 没有直接在TParser上提供Next(): TParser的增量状态就是正在填充的TDocument,
+// 逐个token暂停需要在它的每个回调里加判断, 会拖慢回调式解析的热路径.
+class PullParser {
+  public:
+    explicit PullParser(http_parser_type type) : type_(type) {
+        memset(&settings_, 0, sizeof(settings_));
+        settings_.on_url = sOnUrl;
+        settings_.on_status = sOnStatus;
+        settings_.on_header_field = sOnHeaderField;
+        settings_.on_header_value = sOnHeaderValue;
+        settings_.on_headers_complete = sOnHeadersComplete;
+        settings_.on_body = sOnBody;
+        settings_.on_message_complete = sOnMessageComplete;
+        Reset();
+    }
+    PullParser(PullParser const&) = delete;
+    PullParser& operator=(PullParser const&) = delete;
+
+    /// 提供新的输入, 上一块输入必须已经消耗完(Next()返回过kNeedMore)
+    inline void Feed(const char* buf_ref, size_t len) noexcept {
+        buf_ = buf_ref;
+        len_ = len;
+        pos_ = 0;
+    }
+    inline void Feed(std::string const& buf) noexcept { Feed(buf.c_str(), buf.size()); }
+
+    /// 输入已经结束(链接断开), 有些response需要读取到链接断开为止
+    inline void FeedEof() noexcept {
+        Feed("", 0);
+        eof_ = true;
+    }
+
+    /// 前进到下一个token
+    inline PullToken const& Next() {
+        if (ec_) return SetToken(PullToken::kError);
+
+        // 上一次暂停时一个回调产生了两个token
+        if (queued_) {
+            queued_ = false;
+            return SetToken(PullToken::kHeadersComplete);
+        }
+
+        while (pos_ < len_ || eof_) {
+            eof_ = false;
+            if (HTTP_PARSER_ERRNO(&parser_) == HPE_PAUSED) http_parser_pause(&parser_, 0);
+            pos_ += http_parser_execute(&parser_, &settings_, buf_ + pos_, len_ - pos_);
+
+            enum http_errno err = HTTP_PARSER_ERRNO(&parser_);
+            if (err == HPE_PAUSED) return token_;
+            if (err != HPE_OK) {
+                ec_ = MakeParseErrorCode(err);
+                return SetToken(PullToken::kError);
+            }
+        }
+
+        // 还没结束的值在下次Feed时输入缓冲区可能已经无效, 先保存下来
+        uri_or_status_.Own();
+        key_.Own();
+        value_.Own();
+        return SetToken(PullToken::kNeedMore);
+    }
+
+    /// 最近一个消息是否已经解析完成
+    inline bool ParseDone() const noexcept { return parse_done_; }
+    inline std::error_code ParseError() const noexcept { return ec_; }
+
+    /// 重置解析流状态, 丢弃未消耗的输入
+    inline void Reset() {
+        http_parser_init(&parser_, type_);
+        parser_.data = this;
+        parse_done_ = false;
+        ec_ = std::error_code();
+        buf_ = "";
+        len_ = pos_ = 0;
+        eof_ = false;
+        queued_ = false;
+        ResetMessage();
+    }
+
+    inline bool IsRequest() const noexcept { return type_ == HTTP_REQUEST; }
+    inline bool IsResponse() const noexcept { return type_ == HTTP_RESPONSE; }
+
+  private:
+    static inline PullParser* Self(http_parser* parser) noexcept {
+        return (PullParser*)parser->data;
+    }
+
+    inline PullToken const& SetToken(PullToken::eType type) noexcept {
+        token_.type = type;
+        token_.first = StringRef();
+        token_.second = StringRef();
+        return token_;
+    }
+
+    // 交付一个token并暂停http-parser, 在下一次Next()时继续
+    inline void Emit(PullToken::eType type, StringRef const& first = StringRef(),
+                     StringRef const& second = StringRef()) noexcept {
+        token_.type = type;
+        token_.first = first;
+        token_.second = second;
+        http_parser_pause(&parser_, 1);
+    }
+
+    inline void ResetMessage() noexcept {
+        start_line_done_ = false;
+        kv_state_ = 0;
+        uri_or_status_.Clear();
+        key_.Clear();
+        value_.Clear();
+    }
+
+    static inline int sOnUrl(http_parser* parser, const char* at, size_t length) {
+        Self(parser)->uri_or_status_.Append(at, length);
+        return 0;
+    }
+    static inline int sOnStatus(http_parser* parser, const char* at, size_t length) {
+        Self(parser)->uri_or_status_.Append(at, length);
+        return 0;
+    }
+    static inline int sOnHeaderField(http_parser* parser, const char* at, size_t length) {
+        PullParser* self = Self(parser);
+        if (!self->start_line_done_) {
+            self->FlushStartLine();
+        } else if (self->kv_state_ == 2) {
+            self->FlushField();
+        }
+        self->key_.Append(at, length);
+        self->kv_state_ = 1;
+        return 0;
+    }
+    static inline int sOnHeaderValue(http_parser* parser, const char* at, size_t length) {
+        PullParser* self = Self(parser);
+        self->value_.Append(at, length);
+        self->kv_state_ = 2;
+        return 0;
+    }
+    static inline int sOnHeadersComplete(http_parser* parser) {
+        PullParser* self = Self(parser);
+        if (!self->start_line_done_) {
+            self->FlushStartLine();
+        } else if (self->kv_state_) {
+            self->FlushField();
+        } else {
+            self->Emit(PullToken::kHeadersComplete);
+            return 0;
+        }
+        self->queued_ = true;
+        return 0;
+    }
+    static inline int sOnBody(http_parser* parser, const char* at, size_t length) {
+        Self(parser)->Emit(PullToken::kBody, StringRef(at, length));
+        return 0;
+    }
+    static inline int sOnMessageComplete(http_parser* parser) {
+        PullParser* self = Self(parser);
+        self->parse_done_ = true;
+        self->start_line_done_ = false;
+        self->Emit(PullToken::kMessageComplete);
+        return 0;
+    }
+
+    // 当前的值交给token, 解析器这边腾出来接收下一个值
+    inline void FlushStartLine() noexcept {
+        start_line_done_ = true;
+        parse_done_ = false;
+        std::swap(token_first_, uri_or_status_);
+        uri_or_status_.Clear();
+        token_.method = (http_method)parser_.method;
+        token_.status_code = parser_.status_code;
+        token_.major = parser_.http_major;
+        token_.minor = parser_.http_minor;
+        Emit(IsRequest() ? PullToken::kRequestLine : PullToken::kStatusLine, token_first_.View());
+    }
+    inline void FlushField() noexcept {
+        std::swap(token_first_, key_);
+        std::swap(token_second_, value_);
+        key_.Clear();
+        value_.Clear();
+        kv_state_ = 0;
+        Emit(PullToken::kHeader, token_first_.View(), token_second_.View());
+    }
+
+  private:
+    http_parser_type type_;
+
+    bool parse_done_{false};
+    std::error_code ec_;
+
+    struct http_parser parser_;
+    struct http_parser_settings settings_;
+
+    // 当前输入
+    const char* buf_{""};
+    size_t len_{0};
+    size_t pos_{0};
+    bool eof_{false};
+
+    PullToken token_;
+    bool queued_{false};  // 还有一个kHeadersComplete等待交付
+    detail::PendingValue token_first_;
+    detail::PendingValue token_second_;
+
+    bool start_line_done_{false};
+    int kv_state_{0};  // 0: 没有缓存的域, 1: 正在读key, 2: 正在读value
+    detail::PendingValue uri_or_status_;
+    detail::PendingValue key_;
+    detail::PendingValue value_;
+};
+
+}  // namespace rapidhttp
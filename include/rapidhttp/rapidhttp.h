@@ -1,3 +1,19 @@
 #pragma once
+#include <rapidhttp/batch_parser.h>
+#include <rapidhttp/cookie.h>
+#include <rapidhttp/date_cache.h>
+#include <rapidhttp/dfa_engine.h>
 #include <rapidhttp/doc.h>
+#include <rapidhttp/field_range.h>
+#include <rapidhttp/field_set.h>
+#include <rapidhttp/header_info.h>
+#include <rapidhttp/lookup_tables.h>
+#include <rapidhttp/negotiate.h>
+#include <rapidhttp/output_chain.h>
 #include <rapidhttp/parser.h>
+#include <rapidhttp/parser_features.h>
+#include <rapidhttp/pull_parser.h>
+#include <rapidhttp/response_template.h>
+#include <rapidhttp/sax_parser.h>
+#include <rapidhttp/serialize_cursor.h>
+#include <rapidhttp/url.h>
@@ -6,6 +6,8 @@
 #include <vector>
 
 #include "doc.h"
+#include "negotiate.h"
+#include "url.h"
 // #include "document.h"
 namespace rapidhttp {
 
@@ -31,7 +33,10 @@ struct Method {
     inline const char* toCStr() const noexcept { return http_method_str(http_method(value_)); }
     inline uint32_t strLen() const noexcept { return http_method_str_len(http_method(value_)); }
 
-    static Method from(const char* str) noexcept { return get_http_method(str); }
+    /// 从字符串解析method, 未知的method返回-1(和get_http_method不同, 0是DELETE)
+    static Method from(const char* str) noexcept { return LookupMethod(str, strlen(str)); }
+    /// 同上, 不需要'\0'结尾
+    static Method from(const char* str, size_t len) noexcept { return LookupMethod(str, len); }
 
   private:
     int value_;
@@ -39,7 +44,7 @@ struct Method {
 
 template <class StringT>
 struct TRequest : public TDocument<StringT> {
-    template <class>
+    template <class, class, class, class>
     friend class TParser;
     using base_type = TDocument<StringT>;
     using string_t = typename base_type::string_t;
@@ -50,6 +55,35 @@ struct TRequest : public TDocument<StringT> {
     using base_type::base_type;
 
     inline Method GetMethod() const noexcept { return Method((int)base_type::GetMethod()); }
+
+    /// URI各部分的视图, 解析结果缓存在document中, 多次调用不会重复解析
+    // URI不合法时返回的UrlView::valid为false.
+    inline UrlView GetUrl() const noexcept {
+        const http_parser_url* u = base_type::GetParsedUri();
+        return u ? UrlView::Make(base_type::GetUri().data(), *u) : UrlView();
+    }
+
+    /// 按Accept选择媒体类型, 多个Accept域中的元素合并在一起
+    // @returns: offers中的下标, 没有可接受的类型时返回-1(406 Not Acceptable)
+    inline int NegotiateMedia(const MediaOffers& offers) const noexcept {
+        if (!base_type::FindFieldNoCase("accept", 6)) return offers.Negotiate(nullptr, 0);
+        return offers.Negotiate(base_type::GetFieldElements("accept"));
+    }
+
+    /// 按Accept-Encoding选择内容编码, 多个Accept-Encoding域中的元素合并在一起
+    // @returns: offers中的下标, 没有可接受的编码时返回-1
+    inline int NegotiateEncoding(const EncodingOffers& offers) const noexcept {
+        if (!base_type::FindFieldNoCase("accept-encoding", 15)) return offers.Negotiate(nullptr, 0);
+        return offers.Negotiate(base_type::GetFieldElements("accept-encoding"));
+    }
+
+    /// 查询参数, 可直接用于range-for
+    inline QueryParams GetQueryParams() const noexcept {
+        const http_parser_url* u = base_type::GetParsedUri();
+        if (!u || !(u->field_set & (1 << UF_QUERY))) return QueryParams();
+        return QueryParams(base_type::GetUri().data() + u->field_data[UF_QUERY].off,
+                           u->field_data[UF_QUERY].len);
+    }
 };
 
 }  // namespace rapidhttp
\ No newline at end of file
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <limits.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "layer.hpp"
+
+namespace rapidhttp {
+namespace detail {
+
+// 按机器字读取, 和常量字符串比较时编译器会把右边折叠成立即数
+inline uint16_t Load16(const char* p) noexcept {
+    uint16_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+inline uint32_t Load32(const char* p) noexcept {
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+inline uint64_t Load64(const char* p) noexcept {
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+/// http-parser在path/query/fragment中接受的字符(严格模式): 0x21-0x7e
+inline bool IsUriChar(char c) noexcept { return (uint8_t)(c - 0x21) < 0x5e; }
+
+/// 8个字节中是否有不是uri字符的字节(空格, 控制字符, DEL, 0x80以上)
+inline bool HasNonUriChar(uint64_t w) noexcept {
+    const uint64_t ones = 0x0101010101010101ULL;
+    const uint64_t highs = 0x8080808080808080ULL;
+    return (((w - ones * 0x21) & ~w) | ((w + ones) | w)) & highs;
+}
+
+/// 找到uri的结束位置: 第一个不是uri字符的字节, 没有时返回end
+inline const char* FindUriEnd(const char* p, const char* end) noexcept {
+    for (; end - p >= 8; p += 8)
+        if (HasNonUriChar(Load64(p))) break;
+    while (p < end && IsUriChar(*p)) ++p;
+    return p;
+}
+
+/// 匹配常见的方法, 返回方法名加空格的长度, 不是常见的方法时返回0
+inline size_t MatchCommonMethod(const char* p, http_method* method) noexcept {
+    uint32_t w = Load32(p);
+    if (w == Load32("GET ")) {
+        *method = HTTP_GET;
+        return 4;
+    }
+    if (w == Load32("POST") && p[4] == ' ') {
+        *method = HTTP_POST;
+        return 5;
+    }
+    if (w == Load32("PUT ")) {
+        *method = HTTP_PUT;
+        return 4;
+    }
+    if (w == Load32("HEAD") && p[4] == ' ') {
+        *method = HTTP_HEAD;
+        return 5;
+    }
+    if (w == Load32("DELE") && Load32(p + 3) == Load32("ETE ")) {
+        *method = HTTP_DELETE;
+        return 7;
+    }
+    if (w == Load32("PATC") && Load16(p + 4) == Load16("H ")) {
+        *method = HTTP_PATCH;
+        return 6;
+    }
+    if (Load64(p) == Load64("OPTIONS ")) {
+        *method = HTTP_OPTIONS;
+        return 8;
+    }
+    return 0;
+}
+
+/// 请求行的快速路径
+// 大部分请求行都是"GET /path HTTP/1.1\r\n"这样的形式: 常见的方法, 以'/'开头的uri,
+// HTTP/1.0或HTTP/1.1. 缓冲区中有完整的这种请求行时按机器字比较一次性匹配,
+// 设置好parser并回调on_url, 然后让http-parser直接从第一个域开始;
+// 其它情况(不完整, 不常见的方法, 绝对uri, 非法字符...)返回0, 由http-parser的
+// 状态机逐字节解析, 报错也由状态机完成, 两条路径的结果完全相同.
+// 设置了on_message_begin时不走快速路径(TParser不使用这个回调).
+// @returns: 消耗的字节数, 0表示没有匹配
+inline size_t FastRequestLine(http_parser* parser, const http_parser_settings* settings,
+                              const char* data, size_t len) noexcept {
+    // 最短的"GET / HTTP/1.1\r\n"
+    if (len < 16 || settings->on_message_begin) return 0;
+
+    http_method method;
+    size_t method_len = MatchCommonMethod(data, &method);
+    if (!method_len || data[method_len] != '/') return 0;
+
+    const char* end = data + len;
+    const char* uri = data + method_len;
+    const char* uri_end = FindUriEnd(uri + 1, end);
+    if (end - uri_end < 11 || Load64(uri_end) != Load64(" HTTP/1.") ||
+        (uri_end[8] != '0' && uri_end[8] != '1') || Load16(uri_end + 9) != Load16("\r\n"))
+        return 0;
+    size_t size = uri_end + 11 - data;
+    if (size > max_header_size) return 0;
+
+    parser->flags = 0;
+    parser->uses_transfer_encoding = 0;
+    parser->content_length = ULLONG_MAX;
+    parser->method = method;
+
+    // 回调暂停或失败时, 状态和http-parser在uri之后的空格处停下时一样
+    parser->state = s_req_http_start;
+    parser->nread = (uint32_t)(uri_end + 1 - data);
+    if (settings->on_url && settings->on_url(parser, uri, uri_end - uri) != 0)
+        parser->http_errno = HPE_CB_url;
+    if (HTTP_PARSER_ERRNO(parser) != HPE_OK) return uri_end + 1 - data;
+
+    parser->http_major = 1;
+    parser->http_minor = uri_end[8] - '0';
+    parser->state = s_header_field_start;
+    parser->nread = (uint32_t)size;
+    return size;
+}
+
+}  // namespace detail
+}  // namespace rapidhttp
@@ -12,7 +12,7 @@ namespace rapidhttp {
 
 template <class StringT>
 struct TResponse : public TDocument<StringT> {
-    template <class>
+    template <class, class, class, class>
     friend class TParser;
     using base_type = TDocument<StringT>;
     using string_t = typename base_type::string_t;
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <stddef.h>
+#include <string.h>
+
+#include <string>
+#include <type_traits>
+
+#include "util.h"
+
+/// 编译期拼接的状态行, 如 RAPIDHTTP_STATUS_LINE(200, "OK") => "HTTP/1.1 200 OK\r\n"
+#define RAPIDHTTP_STATUS_LINE(code, reason) "HTTP/1.1 " #code " " reason "\r\n"
+
+namespace rapidhttp {
+
+/// 编译期确定的固定片段, 只引用字符串字面量
+struct StaticPiece {
+    template <size_t N>
+    constexpr StaticPiece(const char (&str)[N]) noexcept : data(str), size(N - 1) {}
+
+    const char* data;
+    size_t size;
+};
+
+namespace detail {
+// 槽位的值: 无符号整数按十进制写入, 字符串类(data()/size())直接拷贝
+struct SlotWriter {
+    template <typename I>
+    static inline typename std::enable_if<std::is_integral<I>::value, size_t>::type Size(
+        I i) noexcept {
+        return UInteger64ByteSize((uint64_t)i);
+    }
+    template <typename I>
+    static inline typename std::enable_if<std::is_integral<I>::value, char*>::type Write(
+        char* buf, I i) noexcept {
+        return WriteUInteger(buf, (uint64_t)i, UInteger64ByteSize((uint64_t)i));
+    }
+
+    template <typename S>
+    static inline auto Size(const S& s) noexcept -> decltype((size_t)s.size()) {
+        return s.size();
+    }
+    template <typename S>
+    static inline auto Write(char* buf, const S& s) noexcept -> decltype((void)s.data(), buf + 0) {
+        memcpy(buf, s.data(), s.size());
+        return buf + s.size();
+    }
+
+    static inline size_t Size(const char* s) noexcept { return strlen(s); }
+    static inline char* Write(char* buf, const char* s) noexcept {
+        size_t len = strlen(s);
+        memcpy(buf, s, len);
+        return buf + len;
+    }
+};
+}  // namespace detail
+
+/// 编译期预渲染的response模板
+// 由Slots+1个固定片段和Slots个槽位交替组成: piece0 slot0 piece1 slot1 ... pieceN.
+// 固定片段(状态行, 固定的域)在编译期拼好, 序列化时只需要按顺序memcpy,
+// 槽位在序列化时按类型写入(整数如Content-Length, 字符串如body).
+//
+//   static constexpr auto c_health = MakeResponseTemplate(
+//       RAPIDHTTP_STATUS_LINE(200, "OK") "Content-Type: text/plain\r\nContent-Length: ",
+//       "\r\n\r\n", "");
+//   c_health.Serialize(buf, len, body.size(), body);
+template <size_t Slots>
+class TResponseTemplate {
+  public:
+    template <typename... Pieces>
+    constexpr TResponseTemplate(const Pieces&... pieces) noexcept
+        : pieces_{StaticPiece(pieces)...} {
+        static_assert(sizeof...(Pieces) == Slots + 1, "need Slots+1 fixed pieces");
+    }
+
+    /// 固定片段的总长度
+    constexpr size_t FixedSize(size_t index = 0) const noexcept {
+        return index > Slots ? 0 : pieces_[index].size + FixedSize(index + 1);
+    }
+
+    constexpr const StaticPiece& Piece(size_t index) const noexcept { return pieces_[index]; }
+
+    /// 填入槽位后的序列化长度
+    template <typename... Values>
+    inline size_t ByteSize(const Values&... values) const noexcept {
+        static_assert(sizeof...(Values) == Slots, "need one value for each slot");
+        return FixedSize() + SlotsSize(values...);
+    }
+
+    /// 序列化
+    template <typename... Values>
+    inline bool Serialize(char* buf, size_t len, const Values&... values) const noexcept {
+        if (len < ByteSize(values...)) return false;
+        Write<0>(buf, values...);
+        return true;
+    }
+
+    template <typename... Values>
+    inline std::string SerializeAsString(const Values&... values) const {
+        std::string s;
+        s.resize(ByteSize(values...));
+        Write<0>(&s[0], values...);
+        return s;
+    }
+
+  private:
+    static inline size_t SlotsSize() noexcept { return 0; }
+    template <typename V, typename... Rest>
+    static inline size_t SlotsSize(const V& value, const Rest&... rest) noexcept {
+        return detail::SlotWriter::Size(value) + SlotsSize(rest...);
+    }
+
+    template <size_t I>
+    inline char* Write(char* buf) const noexcept {
+        memcpy(buf, pieces_[I].data, pieces_[I].size);
+        return buf + pieces_[I].size;
+    }
+    template <size_t I, typename V, typename... Rest>
+    inline char* Write(char* buf, const V& value, const Rest&... rest) const noexcept {
+        memcpy(buf, pieces_[I].data, pieces_[I].size);
+        buf = detail::SlotWriter::Write(buf + pieces_[I].size, value);
+        return Write<I + 1>(buf, rest...);
+    }
+
+  private:
+    StaticPiece pieces_[Slots + 1];
+};
+
+template <typename... Pieces>
+constexpr TResponseTemplate<sizeof...(Pieces) - 1> MakeResponseTemplate(
+    const Pieces&... pieces) noexcept {
+    return TResponseTemplate<sizeof...(Pieces) - 1>(pieces...);
+}
+
+}  // namespace rapidhttp
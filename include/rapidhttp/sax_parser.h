@@ -0,0 +1,232 @@
+#pragma once
+
+#include <stddef.h>
+#include <string.h>
+
+#include <string>
+#include <system_error>
+#include <utility>
+
+#include "error_code.h"
+#include "layer.hpp"
+#include "stringref.h"
+
+namespace rapidhttp {
+
+namespace detail {
+// 一个可能被切成多段的值: 同一块缓冲区内的分段直接扩展视图, 否则拼接到owned
+struct PendingValue {
+    const char* data{nullptr};
+    size_t size{0};
+    std::string owned;
+
+    inline void Append(const char* at, size_t length) {
+        if (!owned.empty()) {
+            owned.append(at, length);
+        } else if (!size) {
+            data = at;
+            size = length;
+        } else if (data + size == at) {
+            size += length;
+        } else {
+            owned.assign(data, size);
+            owned.append(at, length);
+        }
+    }
+    inline void Own() {
+        if (owned.empty() && size) owned.assign(data, size);
+    }
+    inline StringRef View() const noexcept {
+        return owned.empty() ? StringRef(data, size) : StringRef(owned.data(), owned.size());
+    }
+    inline void Clear() noexcept {
+        data = nullptr;
+        size = 0;
+        owned.clear();
+    }
+};
+}  // namespace detail
+
+/// SAX解析的事件处理器基类, 所有事件默认什么都不做
+// 处理器只需覆盖(同名隐藏)关心的事件, 调用是静态分派的, 不经过虚函数.
+// 事件参数都指向输入缓冲区(跨PartailParse调用被切断的值才会拼接到解析器内部),
+// 只在事件回调期间有效.
+struct SaxHandler {
+    inline void on_method(http_method) {}
+    inline void on_uri(StringRef const&) {}
+    inline void on_status(int /*code*/, StringRef const& /*reason*/) {}
+    inline void on_header(StringRef const& /*name*/, StringRef const& /*value*/) {}
+    inline void on_headers_complete(int /*major*/, int /*minor*/) {}
+    // body可能分多次到达, chunked时已经去掉了分块格式
+    inline void on_body(const char*, size_t) {}
+    inline void on_message_complete() {}
+};
+
+/// 不生成document的事件驱动解析器
+// 与TParser共用http-parser, 但不把结果写入TDocument, 而是直接把事件交给Handler.
+// Handler是模板参数, 事件处理可以被完全内联进回调.
+//
+//   struct Tap : rapidhttp::SaxHandler {
+//       void on_header(StringRef const& name, StringRef const& value) { ... }
+//   };
+//   rapidhttp::TSaxParser<Tap> parser(rapidhttp::HTTP_REQUEST);
+//   parser.PartailParse(buf, len);
+template <typename Handler>
+class TSaxParser {
+  public:
+    explicit TSaxParser(http_parser_type type, Handler handler = Handler())
+        : type_(type), handler_(std::move(handler)) {
+        memset(&settings_, 0, sizeof(settings_));
+        settings_.on_message_begin = sOnMessageBegin;
+        settings_.on_url = sOnUrl;
+        settings_.on_status = sOnStatus;
+        settings_.on_header_field = sOnHeaderField;
+        settings_.on_header_value = sOnHeaderValue;
+        settings_.on_headers_complete = sOnHeadersComplete;
+        settings_.on_body = sOnBody;
+        settings_.on_message_complete = sOnMessageComplete;
+        Reset();
+    }
+    TSaxParser(TSaxParser const&) = delete;
+    TSaxParser& operator=(TSaxParser const&) = delete;
+
+    /// 流式解析, 语义同TParser::PartailParse
+    // @returns: 已成功解析的数据长度
+    inline size_t PartailParse(const char* buf_ref, size_t len) {
+        if (ParseDone() || ParseError()) Reset();
+
+        size_t parsed = http_parser_execute(&parser_, &settings_, buf_ref, len);
+        if (parser_.http_errno) ec_ = MakeParseErrorCode(parser_.http_errno);
+
+        // 还没结束的值在下次调用时输入缓冲区可能已经无效, 先保存下来
+        uri_or_status_.Own();
+        key_.Own();
+        value_.Own();
+        return parsed;
+    }
+    inline size_t PartailParse(std::string const& buf) {
+        return PartailParse(buf.c_str(), buf.size());
+    }
+
+    /// 解析eof, 语义同TParser::PartailParseEof
+    inline bool PartailParseEof() {
+        if (ParseDone() || ParseError()) return false;
+
+        PartailParse("", 0);
+        return ParseDone();
+    }
+
+    inline bool ParseDone() const noexcept { return parse_done_; }
+    inline std::error_code ParseError() const noexcept { return ec_; }
+
+    inline void Reset() {
+        http_parser_init(&parser_, type_);
+        parser_.data = this;
+        parse_done_ = false;
+        ec_ = std::error_code();
+        start_line_done_ = false;
+        kv_state_ = 0;
+        uri_or_status_.Clear();
+        key_.Clear();
+        value_.Clear();
+    }
+
+    inline Handler& GetHandler() noexcept { return handler_; }
+    inline Handler const& GetHandler() const noexcept { return handler_; }
+
+    inline bool IsRequest() const noexcept { return type_ == HTTP_REQUEST; }
+    inline bool IsResponse() const noexcept { return type_ == HTTP_RESPONSE; }
+
+  private:
+    static inline TSaxParser* Self(http_parser* parser) noexcept {
+        return (TSaxParser*)parser->data;
+    }
+
+    static inline int sOnMessageBegin(http_parser* parser) {
+        // pipeline的下一个消息开始了, 它完整之前ParseDone()为false
+        Self(parser)->parse_done_ = false;
+        return 0;
+    }
+    static inline int sOnUrl(http_parser* parser, const char* at, size_t length) {
+        TSaxParser* self = Self(parser);
+        if (!self->uri_or_status_.size && self->uri_or_status_.owned.empty())
+            self->handler_.on_method((http_method)parser->method);
+        self->uri_or_status_.Append(at, length);
+        return 0;
+    }
+    static inline int sOnStatus(http_parser* parser, const char* at, size_t length) {
+        Self(parser)->uri_or_status_.Append(at, length);
+        return 0;
+    }
+    static inline int sOnHeaderField(http_parser* parser, const char* at, size_t length) {
+        TSaxParser* self = Self(parser);
+        self->FlushStartLine();
+        if (self->kv_state_ == 2) self->FlushField();
+        self->key_.Append(at, length);
+        self->kv_state_ = 1;
+        return 0;
+    }
+    static inline int sOnHeaderValue(http_parser* parser, const char* at, size_t length) {
+        TSaxParser* self = Self(parser);
+        self->value_.Append(at, length);
+        self->kv_state_ = 2;
+        return 0;
+    }
+    static inline int sOnHeadersComplete(http_parser* parser) {
+        TSaxParser* self = Self(parser);
+        self->FlushStartLine();
+        if (self->kv_state_) self->FlushField();
+        self->handler_.on_headers_complete(parser->http_major, parser->http_minor);
+        return 0;
+    }
+    static inline int sOnBody(http_parser* parser, const char* at, size_t length) {
+        Self(parser)->handler_.on_body(at, length);
+        return 0;
+    }
+    static inline int sOnMessageComplete(http_parser* parser) {
+        TSaxParser* self = Self(parser);
+        self->parse_done_ = true;
+        // 同一块缓冲区中可能紧跟着下一个pipeline的消息
+        self->start_line_done_ = false;
+        self->kv_state_ = 0;
+        self->uri_or_status_.Clear();
+        self->key_.Clear();
+        self->value_.Clear();
+        self->handler_.on_message_complete();
+        return 0;
+    }
+
+    inline void FlushStartLine() {
+        if (start_line_done_) return;
+        start_line_done_ = true;
+        if (IsRequest())
+            handler_.on_uri(uri_or_status_.View());
+        else
+            handler_.on_status(parser_.status_code, uri_or_status_.View());
+        uri_or_status_.Clear();
+    }
+    inline void FlushField() {
+        handler_.on_header(key_.View(), value_.View());
+        key_.Clear();
+        value_.Clear();
+        kv_state_ = 0;
+    }
+
+  private:
+    http_parser_type type_;
+    Handler handler_;
+
+    bool parse_done_{false};
+    std::error_code ec_;
+
+    struct http_parser parser_;
+    struct http_parser_settings settings_;
+
+    bool start_line_done_{false};
+    int kv_state_{0};  // 0: 没有缓存的域, 1: 正在读key, 2: 正在读value
+    detail::PendingValue uri_or_status_;
+    detail::PendingValue key_;
+    detail::PendingValue value_;
+};
+
+}  // namespace rapidhttp
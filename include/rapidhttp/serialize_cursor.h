@@ -0,0 +1,92 @@
+#pragma once
+
+#include <string.h>
+#include <sys/uio.h>
+
+#include <algorithm>
+
+#include "date_cache.h"
+#include "doc.h"
+
+namespace rapidhttp {
+
+/// 可恢复的序列化游标
+// 每次调用Serialize把document的剩余数据尽量写满给定的缓冲区, 并记住写到哪里,
+// 下次调用从断点继续. 每个在途response只需要一块固定大小的输出缓冲区.
+// 游标只引用document, 在Done()之前document不能被修改或析构.
+// Date域在Reset时拷贝到游标内部: DateCache的快照属于调用线程并且每秒刷新,
+// 跨越多次调用(甚至多个线程)写出的Date域不会被撕裂.
+template <typename StringT>
+class TSerializeCursor {
+  public:
+    using document_type = TDocument<StringT>;
+
+    TSerializeCursor() noexcept = default;
+    explicit TSerializeCursor(const document_type& doc) noexcept { Reset(doc); }
+
+    /// 绑定一个新的document, 从头开始序列化
+    inline void Reset(const document_type& doc) noexcept {
+        doc_ = &doc;
+        use_cache_ = !doc.cache_dirty_;
+        date_index_ = doc.DatePieceIndex(use_cache_);
+        if (date_index_ != (size_t)-1) memcpy(date_, DateCache::Instance().Line(), sizeof(date_));
+        index_ = 0;
+        offset_ = 0;
+        written_ = 0;
+        total_ = doc.ByteSize();
+        done_ = !total_ || !GetPiece(0);
+    }
+
+    /// 序列化到buf, 最多写入len字节
+    // @returns: 本次写入的字节数, document未初始化或已经写完时返回0
+    inline size_t Serialize(char* buf, size_t len) noexcept {
+        size_t bytes = 0;
+        while (!done_ && bytes < len) {
+            size_t n = std::min(piece_.iov_len - offset_, len - bytes);
+            memcpy(buf + bytes, (const char*)piece_.iov_base + offset_, n);
+            bytes += n;
+            offset_ += n;
+            if (offset_ == piece_.iov_len) {
+                offset_ = 0;
+                done_ = !GetPiece(++index_);
+            }
+        }
+        written_ += bytes;
+        return bytes;
+    }
+
+    /// 是否已经全部写完
+    inline bool Done() const noexcept { return done_ || written_ == total_; }
+
+    /// 序列化后的总长度, document未初始化时返回0
+    inline size_t ByteSize() const noexcept { return total_; }
+
+    /// 已写入的字节数
+    inline size_t Written() const noexcept { return written_; }
+
+    /// 剩余未写入的字节数
+    inline size_t Remaining() const noexcept { return total_ - written_; }
+
+  private:
+    inline bool GetPiece(size_t index) noexcept {
+        if (!doc_->GetPiece(index, use_cache_, &piece_)) return false;
+        if (index == date_index_) piece_.iov_base = date_;
+        return true;
+    }
+
+  private:
+    const document_type* doc_{nullptr};
+    bool use_cache_{false};
+    bool done_{true};
+    size_t index_{0};   // 当前段的序号
+    size_t offset_{0};  // 当前段内已写入的字节数
+    struct iovec piece_ {};
+    size_t written_{0};
+    size_t total_{0};
+    size_t date_index_{(size_t)-1};     // Date域那一段的序号
+    char date_[DateCache::c_line_size];  // Reset时的Date域
+};
+
+using SerializeCursor = TSerializeCursor<std::string>;
+
+}  // namespace rapidhttp
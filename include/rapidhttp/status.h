@@ -1,5 +1,8 @@
 #pragma once
 
+#include "layer.hpp"
+#include "lookup_tables.h"
+
 namespace rapidhttp {
 
 class Status {
@@ -213,22 +216,28 @@ class Status {
         xxx_max = 1023
     };
 
-    inline bool isInformational(int code) noexcept {
+    // Status与http_status的取值都是状态码本身, 两者互转没有开销
+    inline constexpr Status(int code = OK) noexcept : value_(code) {}
+    inline constexpr Status(http_status code) noexcept : value_((int)code) {}
+    inline constexpr operator int() const noexcept { return value_; }
+    inline constexpr http_status toHttpStatus() const noexcept { return (http_status)value_; }
+
+    static inline constexpr bool isInformational(int code) noexcept {
         return (code >= 100 && code < 200);
     }  //!< \returns \c true if the given \p code is an informational code.
-    inline bool isSuccessful(int code) noexcept {
+    static inline constexpr bool isSuccessful(int code) noexcept {
         return (code >= 200 && code < 300);
     }  //!< \returns \c true if the given \p code is a successful code.
-    inline bool isRedirection(int code) noexcept {
+    static inline constexpr bool isRedirection(int code) noexcept {
         return (code >= 300 && code < 400);
     }  //!< \returns \c true if the given \p code is a redirectional code.
-    inline bool isClientError(int code) noexcept {
+    static inline constexpr bool isClientError(int code) noexcept {
         return (code >= 400 && code < 500);
     }  //!< \returns \c true if the given \p code is a client error code.
-    inline bool isServerError(int code) noexcept {
+    static inline constexpr bool isServerError(int code) noexcept {
         return (code >= 500 && code < 600);
     }  //!< \returns \c true if the given \p code is a server error code.
-    inline bool isError(int code) noexcept {
+    static inline constexpr bool isError(int code) noexcept {
         return (code >= 400);
     }  //!< \returns \c true if the given \p code is any type of error code.
 
@@ -237,149 +246,22 @@ class Status {
      * \return The standard HTTP reason phrase for the given \p code or an empty \c std::string()
      * if no standard phrase for the given \p code is known.
      */
-    inline const char* toCStr() noexcept {
-        switch (value_) {
-            // ####### 1xx - Informational #######
-            case 100:
-                return "Continue";
-            case 101:
-                return "Switching Protocols";
-            case 102:
-                return "Processing";
-            case 103:
-                return "Early Hints";
-
-            // ####### 2xx - Successful #######
-            case 200:
-                return "OK";
-            case 201:
-                return "Created";
-            case 202:
-                return "Accepted";
-            case 203:
-                return "Non-Authoritative Information";
-            case 204:
-                return "No Content";
-            case 205:
-                return "Reset Content";
-            case 206:
-                return "Partial Content";
-            case 207:
-                return "Multi-Status";
-            case 208:
-                return "Already Reported";
-            case 226:
-                return "IM Used";
-
-            // ####### 3xx - Redirection #######
-            case 300:
-                return "Multiple Choices";
-            case 301:
-                return "Moved Permanently";
-            case 302:
-                return "Found";
-            case 303:
-                return "See Other";
-            case 304:
-                return "Not Modified";
-            case 305:
-                return "Use Proxy";
-            case 307:
-                return "Temporary Redirect";
-            case 308:
-                return "Permanent Redirect";
-
-            // ####### 4xx - Client Error #######
-            case 400:
-                return "Bad Request";
-            case 401:
-                return "Unauthorized";
-            case 402:
-                return "Payment Required";
-            case 403:
-                return "Forbidden";
-            case 404:
-                return "Not Found";
-            case 405:
-                return "Method Not Allowed";
-            case 406:
-                return "Not Acceptable";
-            case 407:
-                return "Proxy Authentication Required";
-            case 408:
-                return "Request Timeout";
-            case 409:
-                return "Conflict";
-            case 410:
-                return "Gone";
-            case 411:
-                return "Length Required";
-            case 412:
-                return "Precondition Failed";
-            case 413:
-                return "Content Too Large";
-            case 414:
-                return "URI Too Long";
-            case 415:
-                return "Unsupported Media Type";
-            case 416:
-                return "Range Not Satisfiable";
-            case 417:
-                return "Expectation Failed";
-            case 418:
-                return "I'm a teapot";
-            case 421:
-                return "Misdirected Request";
-            case 422:
-                return "Unprocessable Content";
-            case 423:
-                return "Locked";
-            case 424:
-                return "Failed Dependency";
-            case 425:
-                return "Too Early";
-            case 426:
-                return "Upgrade Required";
-            case 428:
-                return "Precondition Required";
-            case 429:
-                return "Too Many Requests";
-            case 431:
-                return "Request Header Fields Too Large";
-            case 451:
-                return "Unavailable For Legal Reasons";
-
-            // ####### 5xx - Server Error #######
-            case 500:
-                return "Internal Server Error";
-            case 501:
-                return "Not Implemented";
-            case 502:
-                return "Bad Gateway";
-            case 503:
-                return "Service Unavailable";
-            case 504:
-                return "Gateway Timeout";
-            case 505:
-                return "HTTP Version Not Supported";
-            case 506:
-                return "Variant Also Negotiates";
-            case 507:
-                return "Insufficient Storage";
-            case 508:
-                return "Loop Detected";
-            case 510:
-                return "Not Extended";
-            case 511:
-                return "Network Authentication Required";
-
-            default:
-                return "";
-        }
+    inline const char* toCStr() const noexcept {
+        const char* reason = StatusReason(value_);
+        return reason ? reason : "";
     }
 
+    /// 预渲染的状态行"HTTP/1.1 200 OK\r\n", 未知状态码返回nullptr
+    inline const StatusEntry* entry() const noexcept { return FindStatus(value_); }
+
   private:
     int value_;
 };
 
-}  // namespace rapidhttp
\ No newline at end of file
+static_assert(Status(Status::OK).toHttpStatus() == HTTP_STATUS_OK &&
+                  Status(Status::NotFound).toHttpStatus() == HTTP_STATUS_NOT_FOUND &&
+                  Status(Status::InternalServerError).toHttpStatus() ==
+                      HTTP_STATUS_INTERNAL_SERVER_ERROR,
+              "Status and http_status share the same values");
+
+}  // namespace rapidhttp
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <stddef.h>
+
+#include <deque>
+#include <string>
+
+#if __cplusplus >= 201703L
+#include <string_view>
+#define RAPIDHTTP_HAS_STRING_VIEW 1
+#else
+#define RAPIDHTTP_HAS_STRING_VIEW 0
+#endif
+
+namespace rapidhttp {
+
+/// 解析器拼接分片时使用的存储区
+// 只有不能自行持有数据的StringT(如std::string_view)才会用到,
+// 其中的数据在解析器Reset之前保持有效.
+using FragmentStore = std::deque<std::string>;
+
+/// StringT的统一操作接口
+// 默认实现适用于std::string和StringRef这类自带append/clear的字符串.
+template <typename StringT>
+struct StringTraits {
+    static inline void clear(StringT& s) { s.clear(); }
+
+    static inline void append(StringT& s, const char* at, size_t length, FragmentStore&) {
+        s.append(at, length);
+    }
+
+    /// 原地修改用的可写地址
+    // StringRef这类借用型字符串要求它引用的缓冲区本身可写(如解析时的读缓冲区).
+    static inline char* mutable_data(StringT& s) { return const_cast<char*>(s.data()); }
+
+    /// 截短到n字节, n不能大于当前长度
+    static inline void truncate(StringT& s, size_t n) { s.resize(n); }
+};
+
+#if RAPIDHTTP_HAS_STRING_VIEW
+// std::string_view只是借用外部缓冲区:
+// 连续的分片直接扩展视图, 不连续的分片才拷贝到FragmentStore中拼接.
+template <>
+struct StringTraits<std::string_view> {
+    static inline void clear(std::string_view& s) noexcept { s = std::string_view(); }
+
+    static inline void append(std::string_view& s, const char* at, size_t length,
+                              FragmentStore& store) {
+        if (!length) return;
+
+        if (s.empty()) {
+            s = std::string_view(at, length);
+        } else if (s.data() + s.size() == at) {
+            s = std::string_view(s.data(), s.size() + length);
+        } else {
+            if (store.empty() || store.back().data() != s.data()) store.emplace_back(s);
+            store.back().append(at, length);
+            s = store.back();
+        }
+    }
+
+    static inline char* mutable_data(std::string_view& s) noexcept {
+        return const_cast<char*>(s.data());
+    }
+
+    static inline void truncate(std::string_view& s, size_t n) noexcept {
+        s = std::string_view(s.data(), n);
+    }
+};
+#endif
+
+}  // namespace rapidhttp
@@ -20,6 +20,8 @@ class StringRef {
 
     StringRef(const char* str, uint32_t len) noexcept : owner_(false), len_(len), str_(str) {}
 
+    StringRef(const char* str) noexcept : owner_(false), len_(strlen(str)), str_(str) {}
+
     StringRef(StringRef const& other) {
         if (other.owner_ && other.len_) {
             char* buf = (char*)malloc(other.len_);
@@ -114,6 +116,15 @@ class StringRef {
         }
     }
 
+    /// 只支持缩短, 不会重新分配
+    void resize(size_t n) {
+        assert(n <= len_);
+        if (!n)
+            clear();
+        else
+            len_ = n;
+    }
+
     void append(const char* first, size_t length) { append(first, first + length); }
 
     void append(const char* first, const char* last) {
@@ -0,0 +1,218 @@
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+
+#include <iterator>
+
+#include "layer.hpp"
+#include "stringref.h"
+#include "util.h"
+
+namespace rapidhttp {
+
+/// URI各部分的视图, 全部指向document中保存的URI, 不发生拷贝
+// 在URI被修改或document析构之前有效.
+//   origin-form:    /path?query#fragment
+//   absolute-form:  http://user@host:port/path?query#fragment
+//   authority-form: host:port (CONNECT)
+struct UrlView {
+    StringRef schema;
+    StringRef userinfo;
+    StringRef host;  // IPv6地址不含[]
+    StringRef port;
+    StringRef path;
+    StringRef query;          // 不含'?'
+    StringRef fragment;       // 不含'#'
+    uint16_t port_number{0};  // 没有端口时为0
+    bool valid{false};
+
+    inline explicit operator bool() const noexcept { return valid; }
+
+    /// 从http_parser_parse_url的结果构造
+    static inline UrlView Make(const char* uri, const http_parser_url& u) noexcept {
+        UrlView view;
+        view.valid = true;
+        view.port_number = u.port;
+#define _URL_FIELD(field, uf)                                                    \
+    if (u.field_set & (1 << uf))                                                 \
+        view.field = StringRef(uri + u.field_data[uf].off, u.field_data[uf].len)
+        _URL_FIELD(schema, UF_SCHEMA);
+        _URL_FIELD(userinfo, UF_USERINFO);
+        _URL_FIELD(host, UF_HOST);
+        _URL_FIELD(port, UF_PORT);
+        _URL_FIELD(path, UF_PATH);
+        _URL_FIELD(query, UF_QUERY);
+        _URL_FIELD(fragment, UF_FRAGMENT);
+#undef _URL_FIELD
+        return view;
+    }
+};
+
+/// 查询参数, key和value都是未解码的原始数据
+struct QueryParam {
+    StringRef key;
+    StringRef value;  // 没有'='时为空
+
+    /// 解码到buf, buf至少key.size()/value.size()字节
+    // @returns: 解码后的长度
+    inline size_t DecodeKey(char* buf) const noexcept {
+        return PercentDecode(key.data(), key.size(), buf);
+    }
+    inline size_t DecodeValue(char* buf) const noexcept {
+        return PercentDecode(value.data(), value.size(), buf);
+    }
+};
+
+/// 查询参数的前向迭代器, 按'&'切分, 跳过空参数, 不分配内存
+class QueryIterator {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = QueryParam;
+    using difference_type = ptrdiff_t;
+    using pointer = const QueryParam*;
+    using reference = const QueryParam&;
+
+    QueryIterator() noexcept = default;
+    QueryIterator(const char* pos, const char* last) noexcept : pos_(pos), last_(last) { Next(); }
+
+    inline reference operator*() const noexcept { return param_; }
+    inline pointer operator->() const noexcept { return &param_; }
+    inline QueryIterator& operator++() noexcept {
+        Next();
+        return *this;
+    }
+    inline QueryIterator operator++(int) noexcept {
+        QueryIterator it = *this;
+        Next();
+        return it;
+    }
+    friend inline bool operator==(QueryIterator const& lhs, QueryIterator const& rhs) noexcept {
+        return lhs.current_ == rhs.current_;
+    }
+    friend inline bool operator!=(QueryIterator const& lhs, QueryIterator const& rhs) noexcept {
+        return !(lhs == rhs);
+    }
+
+  private:
+    inline void Next() noexcept {
+        while (pos_ < last_) {
+            const char* first = pos_;
+            const char* amp = (const char*)memchr(first, '&', last_ - first);
+            const char* end = amp ? amp : last_;
+            pos_ = amp ? amp + 1 : last_;
+            if (end == first) continue;
+
+            const char* eq = (const char*)memchr(first, '=', end - first);
+            param_.key = StringRef(first, (eq ? eq : end) - first);
+            param_.value = eq ? StringRef(eq + 1, end - eq - 1) : StringRef();
+            current_ = first;
+            return;
+        }
+        current_ = nullptr;
+    }
+
+  private:
+    const char* pos_{nullptr};
+    const char* last_{nullptr};
+    const char* current_{nullptr};  // 当前参数的起始位置, 结束时为nullptr
+    QueryParam param_;
+};
+
+/// 查询字符串(不含'?')上的参数集合
+class QueryParams {
+  public:
+    QueryParams() noexcept = default;
+    QueryParams(const char* query, size_t len) noexcept : query_(query), len_(len) {}
+    explicit QueryParams(StringRef const& query) noexcept
+        : query_(query.data()), len_(query.size()) {}
+
+    inline QueryIterator begin() const noexcept { return QueryIterator(query_, query_ + len_); }
+    inline QueryIterator end() const noexcept { return QueryIterator(); }
+
+    /// 按未解码的key查找第一个匹配的参数
+    inline bool Find(const char* key, size_t key_len, QueryParam* param) const noexcept {
+        for (QueryIterator it = begin(); it != end(); ++it) {
+            if (it->key.size() == key_len && memcmp(it->key.data(), key, key_len) == 0) {
+                *param = *it;
+                return true;
+            }
+        }
+        return false;
+    }
+    inline bool Find(const char* key, QueryParam* param) const noexcept {
+        return Find(key, strlen(key), param);
+    }
+
+  private:
+    const char* query_{nullptr};
+    size_t len_{0};
+};
+
+namespace detail {
+// RFC 3986 unreserved: ALPHA / DIGIT / "-" / "." / "_" / "~"
+inline bool IsUnreserved(unsigned char c) noexcept {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') ||
+           c == '-' || c == '.' || c == '_' || c == '~';
+}
+inline char ToUpperHex(char c) noexcept { return (c >= 'a' && c <= 'f') ? c - ('a' - 'A') : c; }
+}  // namespace detail
+
+/// 原地规范化以'/'开头的路径, 一次扫描完成(RFC 3986 6.2.2):
+//   1. 解码unreserved字符的%XX, 其他转义的十六进制转为大写
+//   2. 合并连续的'/'
+//   3. 去掉"."和".."段, ".."不会越过根目录
+// 路径在第一个'?'或'#'处结束, 之后的查询串和片段原样前移.
+// @returns: 规范化后的总长度, 不会超过len
+inline size_t NormalizePath(char* s, size_t len) noexcept {
+    if (!len || s[0] != '/') return len;
+
+    const char* last = s + len;
+    const char* path_end = s + 1;
+    while (path_end < last && *path_end != '?' && *path_end != '#') ++path_end;
+
+    const char* r = s + 1;
+    char* w = s + 1;
+    while (r < path_end) {
+        char* seg = w;
+        while (r < path_end && *r != '/') {
+            int hi, lo;
+            if (*r == '%' && path_end - r >= 3 && (hi = HexValue(r[1])) >= 0 &&
+                (lo = HexValue(r[2])) >= 0) {
+                unsigned char c = (unsigned char)(hi << 4 | lo);
+                if (detail::IsUnreserved(c)) {
+                    *w++ = (char)c;
+                } else {
+                    *w++ = '%';
+                    *w++ = detail::ToUpperHex(r[1]);
+                    *w++ = detail::ToUpperHex(r[2]);
+                }
+                r += 3;
+            } else {
+                *w++ = *r++;
+            }
+        }
+        bool slash = r < path_end;
+        if (slash) ++r;
+
+        size_t seg_len = w - seg;
+        if (seg_len == 1 && seg[0] == '.') {
+            w = seg;
+        } else if (seg_len == 2 && seg[0] == '.' && seg[1] == '.') {
+            // 回退到上一段的开头
+            w = seg;
+            if (w - 1 > s) {
+                --w;
+                while (w[-1] != '/') --w;
+            }
+        } else if (seg_len && slash) {
+            *w++ = '/';
+        }
+    }
+
+    size_t rest = last - path_end;
+    memmove(w, path_end, rest);
+    return (w - s) + rest;
+}
+
+}  // namespace rapidhttp
@@ -4,6 +4,10 @@
 #include <stdint.h>
 #include <string.h>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 #include "error_code.h"
 
 namespace rapidhttp {
@@ -31,6 +35,269 @@ inline size_t UIntegerByteSize(uint32_t i) noexcept {
         return 10;
 }
 
+inline size_t UInteger64ByteSize(uint64_t i) noexcept {
+    if (i <= 0xffffffffu) return UIntegerByteSize((uint32_t)i);
+    size_t bytes = 10;
+    for (i /= 10000000000ull; i; i /= 10) ++bytes;
+    return bytes;
+}
+
+/// 写入十进制整数, bytes必须等于UInteger64ByteSize(i)
+// @returns: 写入后的位置
+inline char* WriteUInteger(char* buf, uint64_t i, size_t bytes) noexcept {
+    char* last = buf + bytes;
+    char* pos = last;
+    do {
+        *--pos = '0' + i % 10;
+        i /= 10;
+    } while (pos > buf);
+    return last;
+}
+
+namespace detail {
+// C++11没有std::index_sequence, 编译期生成查找表时使用
+template <size_t... I>
+struct IndexSequence {};
+
+template <typename S1, typename S2>
+struct ConcatIndexSequence;
+
+template <size_t... I1, size_t... I2>
+struct ConcatIndexSequence<IndexSequence<I1...>, IndexSequence<I2...>> {
+    using type = IndexSequence<I1..., (sizeof...(I1) + I2)...>;
+};
+
+template <size_t N>
+struct MakeIndexSequence
+    : ConcatIndexSequence<typename MakeIndexSequence<N / 2>::type,
+                          typename MakeIndexSequence<N - N / 2>::type> {};
+template <>
+struct MakeIndexSequence<0> {
+    using type = IndexSequence<>;
+};
+template <>
+struct MakeIndexSequence<1> {
+    using type = IndexSequence<0>;
+};
+}  // namespace detail
+
+namespace detail {
+// 序列化时用到的固定片段, 零拷贝序列化直接引用这里的数据.
+struct SerializePieces {
+    char request_suffix[100][12];   // " HTTP/1.1\r\n"
+    char response_prefix[100][10];  // "HTTP/1.1 "
+    char status_code[1000][4];      // "200 "
+
+    SerializePieces() noexcept {
+        for (int v = 0; v < 100; ++v) {
+            memcpy(request_suffix[v], " HTTP/x.y\r\n", 12);
+            request_suffix[v][6] = '0' + v / 10;
+            request_suffix[v][8] = '0' + v % 10;
+            memcpy(response_prefix[v], "HTTP/x.y ", 10);
+            response_prefix[v][5] = '0' + v / 10;
+            response_prefix[v][7] = '0' + v % 10;
+        }
+        for (int c = 0; c < 1000; ++c) {
+            status_code[c][0] = '0' + c / 100;
+            status_code[c][1] = '0' + (c % 100) / 10;
+            status_code[c][2] = '0' + c % 10;
+            status_code[c][3] = ' ';
+        }
+    }
+
+    static const SerializePieces& Instance() noexcept {
+        static const SerializePieces pieces;
+        return pieces;
+    }
+};
+}  // namespace detail
+
+/// 解析十进制无符号整数, 全部是数字且不溢出时返回true
+inline bool ParseUInteger(const char* s, size_t len, uint64_t* out) noexcept {
+    if (!len) return false;
+    uint64_t v = 0;
+    for (size_t i = 0; i < len; ++i) {
+        unsigned d = (unsigned)(s[i] - '0');
+        if (d > 9 || v > (UINT64_MAX - d) / 10) return false;
+        v = v * 10 + d;
+    }
+    *out = v;
+    return true;
+}
+
+inline char ToLower(char c) noexcept { return (c >= 'A' && c <= 'Z') ? c + ('a' - 'A') : c; }
+
+/// 忽略大小写比较, lower必须是小写的(一般是字面量)
+inline bool EqualsNoCase(const char* s, size_t len, const char* lower, size_t lower_len) noexcept {
+    if (len != lower_len) return false;
+    for (size_t i = 0; i < len; ++i)
+        if (ToLower(s[i]) != lower[i]) return false;
+    return true;
+}
+/// 忽略大小写比较, 两边都可以是任意大小写(如调用方给出的域名)
+inline bool EqualsIgnoreCase(const char* a, size_t a_len, const char* b, size_t b_len) noexcept {
+    if (a_len != b_len) return false;
+    for (size_t i = 0; i < a_len; ++i)
+        if (ToLower(a[i]) != ToLower(b[i])) return false;
+    return true;
+}
+
+namespace detail {
+// 可选空白(OWS, RFC 9110 5.6.3): 空格和水平制表符
+inline bool IsOWS(char c) noexcept { return c == ' ' || c == '\t'; }
+}  // namespace detail
+
+/// 十六进制字符的值, 非法字符返回-1
+inline int HexValue(char c) noexcept {
+    if (c >= '0' && c <= '9') return c - '0';
+    c |= 0x20;
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    return -1;
+}
+
+namespace detail {
+// 查找下一个'%'(或'+'), 没有时返回last
+inline const char* FindEscape(const char* pos, const char* last, bool plus) noexcept {
+#if defined(__SSE2__)
+    const __m128i percent = _mm_set1_epi8('%');
+    const __m128i plus_sign = _mm_set1_epi8(plus ? '+' : '%');
+    for (; last - pos >= 16; pos += 16) {
+        __m128i block = _mm_loadu_si128((const __m128i*)pos);
+        int mask = _mm_movemask_epi8(
+            _mm_or_si128(_mm_cmpeq_epi8(block, percent), _mm_cmpeq_epi8(block, plus_sign)));
+        if (mask) return pos + __builtin_ctz(mask);
+    }
+#endif
+    for (; pos < last; ++pos)
+        if (*pos == '%' || (plus && *pos == '+')) return pos;
+    return last;
+}
+
+/// 预取[p, p + size)所在的cache line
+// @write: 之后会写入
+inline void Prefetch(const void* p, size_t size, bool write = false) noexcept {
+#if defined(__GNUC__)
+    const char* first = (const char*)((uintptr_t)p & ~(uintptr_t)63);
+    const char* last = (const char*)p + size;
+    for (; first < last; first += 64) {
+        if (write)
+            __builtin_prefetch(first, 1);
+        else
+            __builtin_prefetch(first, 0);
+    }
+#else
+    (void)p;
+    (void)size;
+    (void)write;
+#endif
+}
+
+// 换行是不是头部结束的空行的第二个LF("\n\r\n"或"\n\n")
+inline bool IsBlankLineEnd(const char* first, const char* lf) noexcept {
+    return (lf - first >= 1 && lf[-1] == '\n') ||
+           (lf - first >= 2 && lf[-1] == '\r' && lf[-2] == '\n');
+}
+
+/// 查找头部结束的空行, 一次检查16字节(SSE2)
+// 和http-parser一样也接受只有LF的换行. 判断时会往前看两个字节, [first, pos)是
+// 上次已经扫描过的部分, 从pos继续扫描.
+// @returns: 空行之后的位置, 没有时返回nullptr
+inline const char* FindHeaderEnd(const char* first, const char* pos, const char* last) noexcept {
+#if defined(__SSE2__)
+    const __m128i lf = _mm_set1_epi8('\n');
+    for (; last - pos >= 16; pos += 16) {
+        __m128i block = _mm_loadu_si128((const __m128i*)pos);
+        unsigned mask = _mm_movemask_epi8(_mm_cmpeq_epi8(block, lf));
+        for (; mask; mask &= mask - 1) {
+            const char* p = pos + __builtin_ctz(mask);
+            if (IsBlankLineEnd(first, p)) return p + 1;
+        }
+    }
+#endif
+    for (; pos < last; ++pos)
+        if (*pos == '\n' && IsBlankLineEnd(first, pos)) return pos + 1;
+    return nullptr;
+}
+
+// [first, pos)在pos之前跳过空白后是不是换行, 即pos之前的这一行已经结束
+// 跳到first仍然是空白时返回false, 由调用方根据之前的输入判断
+inline bool LineEndedBefore(const char* first, const char* pos) noexcept {
+    while (pos > first && (IsOWS(pos[-1]) || pos[-1] == '\r')) --pos;
+    return pos > first && pos[-1] == '\n';
+}
+}  // namespace detail
+
+/// 百分号解码, 一次跳过16字节不需要解码的数据(SSE2)
+// @plus_as_space: '+'解码为空格(application/x-www-form-urlencoded)
+// dst可以等于src(原地解码), 解码后的长度不会超过len. 不合法的%XX原样保留.
+// @returns: 解码后的长度
+inline size_t PercentDecode(const char* src, size_t len, char* dst,
+                            bool plus_as_space = true) noexcept {
+    const char* pos = src;
+    const char* last = src + len;
+    char* out = dst;
+    while (pos < last) {
+        const char* esc = detail::FindEscape(pos, last, plus_as_space);
+        size_t n = esc - pos;
+        if (out != pos) memmove(out, pos, n);
+        out += n;
+        pos = esc;
+        if (pos == last) break;
+
+        int hi, lo;
+        if (*pos == '+') {
+            *out++ = ' ';
+            ++pos;
+        } else if (last - pos >= 3 && (hi = HexValue(pos[1])) >= 0 &&
+                   (lo = HexValue(pos[2])) >= 0) {
+            *out++ = (char)(hi << 4 | lo);
+            pos += 3;
+        } else {
+            *out++ = *pos++;
+        }
+    }
+    return out - dst;
+}
+
+/// 原地百分号解码
+inline size_t PercentDecodeInPlace(char* s, size_t len, bool plus_as_space = true) noexcept {
+    return PercentDecode(s, len, s, plus_as_space);
+}
+
+namespace detail {
+/// 取列表域(#rule)的下一个元素: 按','切分, 引号内的','不切分, 去掉两边空白, 跳过空元素
+// @returns: 没有更多元素时返回false
+inline bool NextListElement(const char*& pos, const char* last, const char** first,
+                            const char** end) noexcept {
+    while (pos < last) {
+        const char* begin = pos;
+        bool quoted = false;
+        for (; pos < last; ++pos) {
+            if (quoted) {
+                if (*pos == '\\' && pos + 1 < last)
+                    ++pos;
+                else if (*pos == '"')
+                    quoted = false;
+            } else if (*pos == '"') {
+                quoted = true;
+            } else if (*pos == ',') {
+                break;
+            }
+        }
+        const char* stop = pos;
+        if (pos < last) ++pos;
+
+        while (begin < stop && IsOWS(*begin)) ++begin;
+        while (stop > begin && IsOWS(stop[-1])) --stop;
+        if (begin == stop) continue;
+        *first = begin;
+        *end = stop;
+        return true;
+    }
+    return false;
+}
+}  // namespace detail
+
 inline const char* SkipSpaces(const char* pos, const char* last) noexcept {
     for (; pos < last && *pos == ' '; ++pos);
     return pos;
@@ -0,0 +1,59 @@
+#include <gtest/gtest.h>
+#include <rapidhttp/batch_parser.h>
+#include <rapidhttp/parser.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace rapidhttp;
+
+static const std::vector<std::string> c_requests = {
+    "GET /uri/abc HTTP/1.1\r\nHost: domain.com\r\n\r\n",
+    "POST /uri/abc HTTP/1.1\r\nContent-Length: 3\r\n\r\nabc",
+    "POST/uri/abc HTTP/1.1\r\n\r\n",
+    "PUT /a HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n3\r\nabc\r\n0\r\n\r\n",
+    "GET /partial HTTP/1.1\r\nHost: dom",
+};
+
+TEST(batch_parser, parse) {
+    typedef TParser<std::string> Parser;
+    for (size_t distance : {0, 1, 4, 100}) {
+        // 每个请求用单独的解析器, 结果和逐个解析相同
+        std::vector<std::unique_ptr<Parser>> parsers;
+        std::vector<TParseTask<Parser>> tasks;
+        for (auto const& buf : c_requests) {
+            parsers.emplace_back(new Parser(HTTP_REQUEST));
+            tasks.push_back({parsers.back().get(), buf.data(), buf.size(), 0});
+        }
+        ParseBatch(tasks.data(), tasks.size(), distance);
+
+        for (size_t i = 0; i < c_requests.size(); ++i) {
+            Parser expected(HTTP_REQUEST);
+            EXPECT_EQ(tasks[i].parsed, expected.PartailParse(c_requests[i])) << i;
+            EXPECT_EQ(parsers[i]->ParseDone(), expected.ParseDone()) << i;
+            EXPECT_EQ(parsers[i]->ParseError(), expected.ParseError()) << i;
+            EXPECT_EQ(parsers[i]->GetDoc().SerializeAsString(),
+                      expected.GetDoc().SerializeAsString())
+                << i;
+        }
+    }
+}
+
+TEST(batch_parser, same_parser) {
+    // 同一个链接的数据分成多项, 按顺序解析
+    typedef TParser<std::string> Parser;
+    std::string buf = c_requests[1];
+    Parser parser(HTTP_REQUEST);
+    std::vector<TParseTask<Parser>> tasks = {
+        {&parser, buf.data(), 10, 0},
+        {&parser, buf.data() + 10, buf.size() - 10, 0},
+    };
+    ParseBatch(tasks.data(), tasks.size());
+    EXPECT_EQ(tasks[0].parsed + tasks[1].parsed, buf.size());
+    EXPECT_TRUE(parser.ParseDone());
+    EXPECT_EQ(parser.GetDoc().GetBody(), "abc");
+
+    ParseBatch(tasks.data(), 0);
+}
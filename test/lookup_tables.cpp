@@ -0,0 +1,141 @@
+#include <gtest/gtest.h>
+#include <rapidhttp/rapidhttp.h>
+#include <rapidhttp/request.h>
+#include <rapidhttp/response.h>
+#include <string.h>
+
+using namespace std;
+using namespace rapidhttp;
+
+TEST(lookup, method) {
+#define XX(num, name, string)                                    \
+    EXPECT_EQ(num, LookupMethod(#string, strlen(#string)));      \
+    EXPECT_EQ(HTTP_##name, get_http_method(#string));            \
+    EXPECT_EQ(num, (int)Method::from(#string, strlen(#string)));
+    HTTP_METHOD_MAP(XX)
+#undef XX
+
+    EXPECT_EQ(-1, LookupMethod("GETX", 4));
+    EXPECT_EQ(-1, LookupMethod("get", 3));
+    EXPECT_EQ(-1, LookupMethod("GE", 2));
+    EXPECT_EQ(-1, LookupMethod("UNSUBSCRIBEX", 12));
+    // 不需要'\0'结尾
+    EXPECT_EQ(HTTP_POST, LookupMethod("POST /uri HTTP/1.1", 4));
+
+    // 两个Method::from对未知的method都返回-1, get_http_method保持旧行为返回0
+    EXPECT_EQ(-1, (int)Method::from("GETX"));
+    EXPECT_EQ(-1, (int)Method::from("GETX", 4));
+    EXPECT_EQ(HTTP_POST, (int)Method::from("POST"));
+    EXPECT_EQ(HTTP_DELETE, get_http_method("GETX"));
+}
+
+TEST(lookup, status) {
+    EXPECT_STREQ("OK", StatusReason(200));
+    EXPECT_STREQ("Not Found", StatusReason(404));
+    EXPECT_STREQ("I'm a teapot", StatusReason(418));
+    EXPECT_EQ(nullptr, StatusReason(299));
+    EXPECT_EQ(nullptr, StatusReason(99));
+    EXPECT_EQ(nullptr, StatusReason(600));
+    EXPECT_EQ(nullptr, StatusReason(-1));
+
+    const StatusEntry* entry = FindStatus(404);
+    ASSERT_NE(nullptr, entry);
+    EXPECT_EQ(string("HTTP/1.1 404 Not Found\r\n"), string(entry->line, entry->line_len));
+    EXPECT_EQ(9, entry->reason_len);
+
+    Status status(HTTP_STATUS_NOT_FOUND);
+    EXPECT_EQ(Status::NotFound, status);
+    EXPECT_EQ(HTTP_STATUS_NOT_FOUND, status.toHttpStatus());
+    EXPECT_STREQ("Not Found", status.toCStr());
+    EXPECT_STREQ("", Status(299).toCStr());
+    EXPECT_TRUE(Status::isClientError(status));
+
+    // 标准状态行走预渲染路径, 自定义原因短语和版本走普通路径
+    TResponse<std::string> res;
+    res.SetStatus((uint16_t)404);
+    res.SetField("Content-Length", "0");
+    EXPECT_EQ("HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\n\r\n", res.SerializeAsString());
+    res.SetStatus(404, "Nope");
+    EXPECT_EQ("HTTP/1.1 404 Nope\r\nContent-Length: 0\r\n\r\n", res.SerializeAsString());
+    res.SetStatus((uint16_t)425);
+    res.SetMinor(0);
+    EXPECT_EQ("HTTP/1.0 425 Too Early\r\nContent-Length: 0\r\n\r\n", res.SerializeAsString());
+}
+
+TEST(lookup, status_reason_phrases) {
+    // 和原来Status::toCStr中的原因短语保持一致
+    static const struct {
+        int code;
+        const char* reason;
+    } c_phrases[] = {
+        {100, "Continue"},
+        {101, "Switching Protocols"},
+        {102, "Processing"},
+        {103, "Early Hints"},
+        {200, "OK"},
+        {201, "Created"},
+        {202, "Accepted"},
+        {203, "Non-Authoritative Information"},
+        {204, "No Content"},
+        {205, "Reset Content"},
+        {206, "Partial Content"},
+        {207, "Multi-Status"},
+        {208, "Already Reported"},
+        {226, "IM Used"},
+        {300, "Multiple Choices"},
+        {301, "Moved Permanently"},
+        {302, "Found"},
+        {303, "See Other"},
+        {304, "Not Modified"},
+        {305, "Use Proxy"},
+        {307, "Temporary Redirect"},
+        {308, "Permanent Redirect"},
+        {400, "Bad Request"},
+        {401, "Unauthorized"},
+        {402, "Payment Required"},
+        {403, "Forbidden"},
+        {404, "Not Found"},
+        {405, "Method Not Allowed"},
+        {406, "Not Acceptable"},
+        {407, "Proxy Authentication Required"},
+        {408, "Request Timeout"},
+        {409, "Conflict"},
+        {410, "Gone"},
+        {411, "Length Required"},
+        {412, "Precondition Failed"},
+        {413, "Content Too Large"},
+        {414, "URI Too Long"},
+        {415, "Unsupported Media Type"},
+        {416, "Range Not Satisfiable"},
+        {417, "Expectation Failed"},
+        {418, "I'm a teapot"},
+        {421, "Misdirected Request"},
+        {422, "Unprocessable Content"},
+        {423, "Locked"},
+        {424, "Failed Dependency"},
+        {425, "Too Early"},
+        {426, "Upgrade Required"},
+        {428, "Precondition Required"},
+        {429, "Too Many Requests"},
+        {431, "Request Header Fields Too Large"},
+        {451, "Unavailable For Legal Reasons"},
+        {500, "Internal Server Error"},
+        {501, "Not Implemented"},
+        {502, "Bad Gateway"},
+        {503, "Service Unavailable"},
+        {504, "Gateway Timeout"},
+        {505, "HTTP Version Not Supported"},
+        {506, "Variant Also Negotiates"},
+        {507, "Insufficient Storage"},
+        {508, "Loop Detected"},
+        {510, "Not Extended"},
+        {511, "Network Authentication Required"},
+    };
+    for (auto const& p : c_phrases) {
+        EXPECT_STREQ(p.reason, Status(p.code).toCStr()) << p.code;
+        std::string line = "HTTP/1.1 " + std::to_string(p.code) + " " + p.reason + "\r\n";
+        const StatusEntry* entry = FindStatus(p.code);
+        ASSERT_NE(nullptr, entry) << p.code;
+        EXPECT_EQ(line, string(entry->line, entry->line_len)) << p.code;
+    }
+}
@@ -0,0 +1,100 @@
+#include <gtest/gtest.h>
+#include <rapidhttp/parser.h>
+
+#include <string>
+
+#include "rapidhttp/negotiate.h"
+
+using namespace std;
+using namespace rapidhttp;
+
+static int Media(MediaOffers const& offers, const char* accept) {
+    return offers.Negotiate(accept, accept ? strlen(accept) : 0);
+}
+
+static int Encoding(EncodingOffers const& offers, const char* accept) {
+    return offers.Negotiate(accept, accept ? strlen(accept) : 0);
+}
+
+TEST(negotiate, qvalue) {
+    EXPECT_EQ(detail::ParseQValue("1", 1), 1000);
+    EXPECT_EQ(detail::ParseQValue("1.000", 5), 1000);
+    EXPECT_EQ(detail::ParseQValue("0.5", 3), 500);
+    EXPECT_EQ(detail::ParseQValue("0.123", 5), 123);
+    EXPECT_EQ(detail::ParseQValue("0", 1), 0);
+    EXPECT_EQ(detail::ParseQValue("1.5", 3), -1);
+    EXPECT_EQ(detail::ParseQValue("0.1234", 6), -1);
+    EXPECT_EQ(detail::ParseQValue("2", 1), -1);
+}
+
+TEST(negotiate, media) {
+    static const MediaOffers offers{"application/json", "text/html", "text/plain"};
+
+    EXPECT_EQ(Media(offers, nullptr), 0);
+    EXPECT_EQ(Media(offers, "*/*"), 0);
+    EXPECT_EQ(Media(offers, "text/html"), 1);
+    EXPECT_EQ(Media(offers, "TEXT/*;q=0.5, text/plain"), 2);
+    EXPECT_EQ(Media(offers, "text/*, text/html;q=0"), 2);
+    EXPECT_EQ(Media(offers, "text/html;level=1;q=0.9, application/json;q=0.8"), 1);
+    // 更精确的range优先, 即使它的q更低
+    EXPECT_EQ(Media(offers, "*/*;q=1, application/json;q=0.1, text/plain;q=0.2"), 1);
+    // 引号内的','不是分隔符
+    EXPECT_EQ(Media(offers, "text/html;foo=\"a,b\";q=0.3, text/plain;q=0.2"), 1);
+    // 引号内的';'也不是分隔符, 引号里的"q=0"不是q参数
+    EXPECT_EQ(Media(offers, "text/html;x=\"a;q=0\""), 1);
+    EXPECT_EQ(Media(offers, "text/html;x=\"a\\\";q=0\";q=0.5, text/plain;q=0.4"), 1);
+    // 不合法的q参数被忽略, 按1处理
+    EXPECT_EQ(Media(offers, "text/html;q=abc"), 1);
+    EXPECT_EQ(Media(offers, "text/plain;q=0.5, text/html;q=2"), 1);
+    EXPECT_EQ(Media(offers, "image/png"), -1);
+    EXPECT_EQ(Media(offers, "*/*;q=0"), -1);
+
+    std::string buf =
+        "GET / HTTP/1.1\r\n"
+        "accept: image/webp, text/plain;q=0.9, */*;q=0.1\r\n"
+        "Accept-Encoding: gzip;q=0.8, br\r\n"
+        "\r\n";
+    RequestParser parser;
+    EXPECT_EQ(parser.PartailParse(buf), buf.size());
+    auto const& request = (TRequest<std::string> const&)parser.GetDoc();
+    EXPECT_EQ(request.NegotiateMedia(offers), 2);
+    EXPECT_EQ(request.NegotiateEncoding(EncodingOffers{"gzip", "br", "identity"}), 1);
+
+    // 多个同名的列表域等价于用','连接起来的一个域
+    buf =
+        "GET / HTTP/1.1\r\n"
+        "Accept: image/webp;q=0.5\r\n"
+        "Accept-Encoding: gzip;q=0.5\r\n"
+        "ACCEPT: text/html\r\n"
+        "accept-encoding: br, identity;q=0\r\n"
+        "\r\n";
+    EXPECT_EQ(parser.PartailParse(buf), buf.size());
+    auto const& repeated = (TRequest<std::string> const&)parser.GetDoc();
+    EXPECT_EQ(repeated.NegotiateMedia(offers), 1);
+    EXPECT_EQ(repeated.NegotiateEncoding(EncodingOffers{"gzip", "br", "identity"}), 1);
+    EXPECT_EQ(repeated.NegotiateEncoding(EncodingOffers{"deflate", "identity"}), -1);
+
+    // 空的Accept-Encoding只接受identity, 没有Accept-Encoding时任何编码都可以
+    buf = "GET / HTTP/1.1\r\nAccept:\r\nAccept-Encoding:\r\n\r\n";
+    EXPECT_EQ(parser.PartailParse(buf), buf.size());
+    auto const& empty = (TRequest<std::string> const&)parser.GetDoc();
+    EXPECT_EQ(empty.NegotiateMedia(offers), 0);
+    EXPECT_EQ(empty.NegotiateEncoding(EncodingOffers{"gzip", "identity"}), 1);
+    EXPECT_EQ(empty.NegotiateEncoding(EncodingOffers{"gzip"}), -1);
+}
+
+TEST(negotiate, encoding) {
+    static const EncodingOffers offers{"br", "gzip", "identity"};
+
+    EXPECT_EQ(Encoding(offers, nullptr), 2);
+    EXPECT_EQ(Encoding(EncodingOffers{"br", "gzip"}, nullptr), 0);
+    EXPECT_EQ(Encoding(offers, ""), 2);
+    EXPECT_EQ(Encoding(offers, "gzip"), 1);
+    EXPECT_EQ(Encoding(offers, "gzip, br"), 0);
+    EXPECT_EQ(Encoding(offers, "gzip;q=1.0, br;q=0.5"), 1);
+    EXPECT_EQ(Encoding(offers, "*"), 0);
+    EXPECT_EQ(Encoding(offers, "*;q=0.5, br;q=0"), 1);
+    EXPECT_EQ(Encoding(offers, "deflate"), 2);
+    EXPECT_EQ(Encoding(offers, "deflate, identity;q=0"), -1);
+    EXPECT_EQ(Encoding(offers, "deflate, *;q=0"), -1);
+}
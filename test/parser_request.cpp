@@ -1,4 +1,5 @@
 #include <gtest/gtest.h>
+#include <rapidhttp/dfa_engine.h>
 #include <rapidhttp/parser.h>
 #include <unistd.h>
 
@@ -193,5 +194,600 @@ static void copyto_request() {
 TEST(parser, request) {
     test_parse_request<std::string>();
     test_parse_request<StringRef>();
+#if RAPIDHTTP_HAS_STRING_VIEW
+    test_parse_request<std::string_view>();
+#endif
     copyto_request();
 }
+
+static std::string c_http_request_typed =
+    "PUT /upload HTTP/1.1\r\n"
+    "HOST: upload.domain.com\r\n"
+    "Expect: 100-Continue\r\n"
+    "Cache-Control: no-cache, Max-Age=60, private=\"Set-Cookie\"\r\n"
+    "Transfer-Encoding: gzip, chunked\r\n"
+    "\r\n"
+    "3\r\nabc\r\n0\r\n\r\n";
+
+template <typename String>
+static void test_typed_fields() {
+    TRequestParser<String> parser;
+    size_t bytes = parser.PartailParse(c_http_request_2);
+    EXPECT_EQ(bytes, c_http_request_2.size());
+    EXPECT_TRUE(parser.ParseDone());
+    auto const& doc = parser.GetDoc();
+    EXPECT_TRUE(doc.HasContentLength());
+    EXPECT_EQ(doc.ContentLength(), 3);
+    EXPECT_TRUE(doc.KeepAlive());
+    EXPECT_FALSE(doc.IsChunked());
+    EXPECT_FALSE(doc.ExpectContinue());
+    EXPECT_EQ(doc.CacheControl(), 0);
+    EXPECT_EQ(doc.MaxAge(), -1);
+    EXPECT_EQ(doc.Host(), "domain.com");
+
+    bytes = parser.PartailParse(c_http_request_typed);
+    EXPECT_EQ(bytes, c_http_request_typed.size());
+    EXPECT_TRUE(parser.ParseDone());
+    EXPECT_FALSE(doc.HasContentLength());
+    EXPECT_TRUE(doc.IsChunked());
+    EXPECT_TRUE(doc.ExpectContinue());
+    EXPECT_EQ(doc.CacheControl(), kCacheNoCache | kCacheMaxAge | kCachePrivate);
+    EXPECT_EQ(doc.MaxAge(), 60);
+    EXPECT_EQ(doc.Host(), "upload.domain.com");
+    EXPECT_EQ(doc.GetBody(), "abc");
+
+    // 手动构造的document在访问时扫描域
+    TRequest<String> request = parser.StealRequest();
+    EXPECT_TRUE(request.IsChunked());
+    request.SetField("Transfer-Encoding", "identity");
+    request.SetField("Content-Length", "12");
+    request.SetField("Connection", "upgrade, close");
+    request.SetField("Upgrade", "websocket");
+    EXPECT_FALSE(request.IsChunked());
+    EXPECT_TRUE(request.HasContentLength());
+    EXPECT_EQ(request.ContentLength(), 12);
+    EXPECT_FALSE(request.KeepAlive());
+    EXPECT_TRUE(request.IsUpgrade());
+    EXPECT_EQ(request.MaxAge(), 60);
+    EXPECT_EQ(request.Host(), "upload.domain.com");
+
+    request.SetVersion(10);
+    request.SetField("Connection", "Keep-Alive");
+    EXPECT_TRUE(request.KeepAlive());
+    request.SetField("Connection", "");
+    EXPECT_FALSE(request.KeepAlive());
+}
+
+TEST(parser, typed_fields) {
+    test_typed_fields<std::string>();
+    test_typed_fields<StringRef>();
+#if RAPIDHTTP_HAS_STRING_VIEW
+    test_typed_fields<std::string_view>();
+#endif
+}
+
+template <typename String>
+static void test_url() {
+    TRequestParser<String> parser;
+    std::string req = "GET /a/b?x=1&y=2#top HTTP/1.1\r\n\r\n";
+    EXPECT_EQ(parser.PartailParse(req), req.size());
+    auto const& request = (TRequest<String> const&)parser.GetDoc();
+    UrlView url = request.GetUrl();
+    EXPECT_TRUE(url.valid);
+    EXPECT_EQ(url.path, "/a/b");
+    EXPECT_EQ(url.query, "x=1&y=2");
+    EXPECT_EQ(url.fragment, "top");
+    EXPECT_TRUE(url.host.empty());
+    EXPECT_EQ(url.port_number, 0);
+    // 视图指向document中的URI
+    EXPECT_EQ(url.path.data(), request.GetUri().data());
+    EXPECT_EQ(request.GetParsedUri(), request.GetParsedUri());
+
+    req = "GET http://user@example.com:8080/index.html?q HTTP/1.1\r\n\r\n";
+    EXPECT_EQ(parser.PartailParse(req), req.size());
+    url = request.GetUrl();
+    EXPECT_TRUE(url.valid);
+    EXPECT_EQ(url.schema, "http");
+    EXPECT_EQ(url.userinfo, "user");
+    EXPECT_EQ(url.host, "example.com");
+    EXPECT_EQ(url.port, "8080");
+    EXPECT_EQ(url.port_number, 8080);
+    EXPECT_EQ(url.path, "/index.html");
+    EXPECT_EQ(url.query, "q");
+
+    req = "CONNECT [::1]:443 HTTP/1.1\r\n\r\n";
+    EXPECT_EQ(parser.PartailParse(req), req.size());
+    url = request.GetUrl();
+    EXPECT_TRUE(url.valid);
+    EXPECT_EQ(url.host, "::1");
+    EXPECT_EQ(url.port_number, 443);
+    EXPECT_TRUE(url.path.empty());
+
+    // 修改URI之后重新解析
+    TRequest<String> copy = parser.StealRequest();
+    copy.SetMethod(HTTP_GET).SetUri("/new?k=v");
+    EXPECT_EQ(copy.GetUrl().path, "/new");
+    EXPECT_EQ(copy.GetUrl().query, "k=v");
+    copy.SetUri("http:///bad");
+    EXPECT_FALSE(copy.GetUrl().valid);
+    EXPECT_EQ(copy.GetParsedUri(), nullptr);
+}
+
+TEST(parser, url) {
+    test_url<std::string>();
+    test_url<StringRef>();
+#if RAPIDHTTP_HAS_STRING_VIEW
+    test_url<std::string_view>();
+#endif
+}
+
+template <typename String>
+static void test_query() {
+    TRequestParser<String> parser;
+    std::string req = "GET /track?id=42&&name=a%20b+c&flag&=x&empty= HTTP/1.1\r\n\r\n";
+    EXPECT_EQ(parser.PartailParse(req), req.size());
+    auto const& request = (TRequest<String> const&)parser.GetDoc();
+
+    std::vector<std::pair<std::string, std::string>> params;
+    for (auto const& param : request.GetQueryParams()) params.emplace_back(param.key, param.value);
+    ASSERT_EQ(params.size(), 5);
+    EXPECT_EQ(params[0], std::make_pair(std::string("id"), std::string("42")));
+    EXPECT_EQ(params[1], std::make_pair(std::string("name"), std::string("a%20b+c")));
+    EXPECT_EQ(params[2], std::make_pair(std::string("flag"), std::string("")));
+    EXPECT_EQ(params[3], std::make_pair(std::string(""), std::string("x")));
+    EXPECT_EQ(params[4], std::make_pair(std::string("empty"), std::string("")));
+
+    QueryParam param;
+    EXPECT_TRUE(request.GetQueryParams().Find("name", &param));
+    char buf[16];
+    EXPECT_EQ(std::string(buf, param.DecodeValue(buf)), "a b c");
+    EXPECT_FALSE(request.GetQueryParams().Find("nam", &param));
+
+    req = "GET /no-query HTTP/1.1\r\n\r\n";
+    EXPECT_EQ(parser.PartailParse(req), req.size());
+    EXPECT_TRUE(request.GetQueryParams().begin() == request.GetQueryParams().end());
+}
+
+TEST(parser, query) {
+    test_query<std::string>();
+    test_query<StringRef>();
+#if RAPIDHTTP_HAS_STRING_VIEW
+    test_query<std::string_view>();
+#endif
+}
+
+static std::string Normalize(std::string s) {
+    s.resize(NormalizePath(&s[0], s.size()));
+    return s;
+}
+
+template <typename String>
+static void test_normalize_uri() {
+    // 读缓冲区必须可写, StringRef/string_view直接改写其中的URI
+    std::string buf = "GET //a/./b/../%7euser//%2fx%3a/.?q=/../#f HTTP/1.1\r\n\r\n";
+    TRequestParser<String> parser;
+    EXPECT_EQ(parser.PartailParse(buf), buf.size());
+    TRequest<String> request = parser.StealRequest();
+    EXPECT_EQ(request.GetUrl().path, "//a/./b/../%7euser//%2fx%3a/.");
+    EXPECT_TRUE(request.NormalizeUri());
+    EXPECT_EQ(request.GetUri(), "/a/~user/%2Fx%3A/?q=/../#f");
+    EXPECT_EQ(request.GetUrl().path, "/a/~user/%2Fx%3A/");
+    EXPECT_EQ(request.GetUrl().query, "q=/../");
+    EXPECT_EQ(request.SerializeAsString(), "GET /a/~user/%2Fx%3A/?q=/../#f HTTP/1.1\r\n\r\n");
+
+    buf = "GET http://example.com/a/../../b HTTP/1.1\r\n\r\n";
+    EXPECT_EQ(parser.PartailParse(buf), buf.size());
+    request = parser.StealRequest();
+    EXPECT_TRUE(request.NormalizeUri());
+    EXPECT_EQ(request.GetUri(), "http://example.com/b");
+
+    buf = "CONNECT example.com:443 HTTP/1.1\r\n\r\n";
+    EXPECT_EQ(parser.PartailParse(buf), buf.size());
+    request = parser.StealRequest();
+    EXPECT_FALSE(request.NormalizeUri());
+    EXPECT_EQ(request.GetUri(), "example.com:443");
+}
+
+TEST(parser, normalize_uri) {
+    EXPECT_EQ(Normalize(""), "");
+    EXPECT_EQ(Normalize("*"), "*");
+    EXPECT_EQ(Normalize("/"), "/");
+    EXPECT_EQ(Normalize("/.."), "/");
+    EXPECT_EQ(Normalize("/../a"), "/a");
+    EXPECT_EQ(Normalize("/a/b/c/./../../g"), "/a/g");
+    EXPECT_EQ(Normalize("/a/b/.."), "/a/");
+    EXPECT_EQ(Normalize("/a/."), "/a/");
+    EXPECT_EQ(Normalize("/a/.b/..c/"), "/a/.b/..c/");
+    EXPECT_EQ(Normalize("///a////b"), "/a/b");
+    EXPECT_EQ(Normalize("/%2E%2e/%41%2d%7E%25%20"), "/A-~%25%20");
+    EXPECT_EQ(Normalize("/a%2/b%"), "/a%2/b%");
+
+    test_normalize_uri<std::string>();
+    test_normalize_uri<StringRef>();
+#if RAPIDHTTP_HAS_STRING_VIEW
+    test_normalize_uri<std::string_view>();
+#endif
+}
+
+template <typename String>
+static void test_cookie() {
+    std::string buf =
+        "GET / HTTP/1.1\r\n"
+        "cookie: a=1;b = 2 ;; c=\"quoted value\"; flag ; session=abc=def;e=\r\n"
+        "\r\n";
+    TRequestParser<String> parser;
+    EXPECT_EQ(parser.PartailParse(buf), buf.size());
+    auto const& doc = parser.GetDoc();
+
+    std::vector<std::pair<std::string, std::string>> cookies;
+    for (auto const& cookie : doc.Cookies()) cookies.emplace_back(cookie.name, cookie.value);
+    ASSERT_EQ(cookies.size(), 6);
+    EXPECT_EQ(cookies[0], std::make_pair(std::string("a"), std::string("1")));
+    EXPECT_EQ(cookies[1], std::make_pair(std::string("b"), std::string("2")));
+    EXPECT_EQ(cookies[2], std::make_pair(std::string("c"), std::string("quoted value")));
+    EXPECT_EQ(cookies[3], std::make_pair(std::string(""), std::string("flag")));
+    EXPECT_EQ(cookies[4], std::make_pair(std::string("session"), std::string("abc=def")));
+    EXPECT_EQ(cookies[5], std::make_pair(std::string("e"), std::string("")));
+
+    StringRef value;
+    EXPECT_TRUE(doc.FindCookie("session", &value));
+    EXPECT_EQ(value, "abc=def");
+    // 指向域的值
+    EXPECT_GE(value.data(), doc.GetFields()[0].second.data());
+    EXPECT_FALSE(doc.FindCookie("sess", &value));
+    EXPECT_FALSE(doc.FindCookie("def", &value));
+    EXPECT_TRUE(doc.FindCookie("c", &value));
+    EXPECT_EQ(value, "quoted value");
+    EXPECT_TRUE(doc.FindCookie("e", &value));
+    EXPECT_TRUE(value.empty());
+    EXPECT_TRUE(doc.FindCookie("b", &value));
+    EXPECT_EQ(value, "2");
+
+    parser.PartailParse(c_http_request);
+    EXPECT_FALSE(parser.GetDoc().FindCookie("a", &value));
+    EXPECT_TRUE(parser.GetDoc().Cookies().begin() == parser.GetDoc().Cookies().end());
+}
+
+TEST(parser, cookie) {
+    test_cookie<std::string>();
+    test_cookie<StringRef>();
+#if RAPIDHTTP_HAS_STRING_VIEW
+    test_cookie<std::string_view>();
+#endif
+}
+
+RAPIDHTTP_FIELD_SET(TestFields, "Host", "Content-Length", "X-Request-Id");
+
+template <typename String>
+static void test_field_set() {
+    std::string request =
+        "POST /uri/abc HTTP/1.1\r\n"
+        "Accept: XAccept\r\n"
+        "host: domain.com\r\n"
+        "User-Agent: gtest.proxy\r\n"
+        "X-Empty:\r\n"
+        "X-Request-Id: 42\r\n"
+        "Connection: close\r\n"
+        "Content-Length: 3\r\n"
+        "\r\nabc";
+
+    // 任意位置切开, 不关心的域被分段时也不影响结果
+    for (size_t pos = 1; pos < request.size(); ++pos) {
+        TRequestParser<String, TestFields> parser;
+        size_t bytes = parser.PartailParse(request.c_str(), pos);
+        bytes += parser.PartailParse(request.c_str() + bytes, request.size() - bytes);
+        EXPECT_EQ(bytes, request.size()) << pos;
+        EXPECT_TRUE(parser.ParseDone()) << pos;
+
+        auto const& doc = parser.GetDoc();
+        ASSERT_EQ(doc.GetFields().size(), 3u) << pos;
+        EXPECT_EQ(doc.GetFields()[0].first, "host");
+        EXPECT_EQ(doc.GetFields()[1].first, "X-Request-Id");
+        EXPECT_EQ(doc.GetFields()[1].second, "42");
+        EXPECT_EQ(doc.GetField("Content-Length"), "3");
+        EXPECT_EQ(doc.GetBody(), "abc");
+        // http-parser算出的结果不受影响
+        EXPECT_EQ(doc.ContentLength(), 3u);
+        EXPECT_FALSE(doc.KeepAlive());
+        EXPECT_EQ(doc.Host(), "domain.com");
+    }
+
+    // 不关心的域仍然会被校验
+    TRequestParser<String, TestFields> parser;
+    parser.PartailParse("GET / HTTP/1.1\r\nBad Field: x\r\n\r\n");
+    EXPECT_TRUE(!!parser.ParseError());
+}
+
+TEST(parser, field_set) {
+    test_field_set<std::string>();
+    test_field_set<StringRef>();
+#if RAPIDHTTP_HAS_STRING_VIEW
+    test_field_set<std::string_view>();
+#endif
+}
+
+// 全部可选功能都关闭的解析器
+template <typename String>
+using MinimalParser = TParser<String, AllFields, TParserFeatures<0>>;
+
+template <typename String>
+static std::error_code parse_with_split(std::string const& request, size_t pos) {
+    MinimalParser<String> parser(HTTP_REQUEST);
+    size_t bytes = parser.PartailParse(request.c_str(), pos);
+    if (!parser.ParseError())
+        parser.PartailParse(request.c_str() + bytes, request.size() - bytes);
+    EXPECT_TRUE(parser.ParseDone() || parser.ParseError());
+    return parser.ParseError();
+}
+
+template <typename String>
+static void test_features() {
+    std::string upgrade =
+        "GET /chat HTTP/1.1\r\n"
+        "Host: domain.com\r\n"
+        "Upgrade: websocket\r\n"
+        "Connection: Upgrade\r\n"
+        "Content-Length: 3\r\n"
+        "\r\nabc";
+    std::string chunked =
+        "POST / HTTP/1.1\r\n"
+        "Transfer-Encoding: chunked\r\n"
+        "\r\n3\r\nabc\r\n0\r\n\r\n";
+    std::string connect = "CONNECT domain.com:443 HTTP/1.1\r\nHost: domain.com\r\n\r\n";
+    std::string folded =
+        "GET / HTTP/1.1\r\n"
+        "X-Folded: a\r\n"
+        " b\r\n"
+        "Host: domain.com\r\n"
+        "\r\n";
+    // 空值之后的折行
+    std::string folded_empty =
+        "GET / HTTP/1.1\r\n"
+        "X-Folded:\r\n"
+        " b\r\n"
+        "X-Folded-Ws: \r\n"
+        "\t c\r\n"
+        "\r\n";
+    // 空值不是折行
+    std::string empty =
+        "GET / HTTP/1.1\r\n"
+        "X-Empty:\r\n"
+        "X-Empty-Ws:  \r\n"
+        "Host: domain.com\r\n"
+        "\r\n";
+    std::error_code disabled = MakeErrorCode(eErrorCode::feature_disabled);
+
+    // 关闭的功能在任意位置切开都能被识别, 普通的消息不受影响
+    for (size_t pos = 1; pos < upgrade.size(); ++pos)
+        EXPECT_FALSE(parse_with_split<String>(upgrade, pos)) << pos;
+    for (size_t pos = 1; pos < c_http_request.size(); ++pos)
+        EXPECT_FALSE(parse_with_split<String>(c_http_request, pos)) << pos;
+    for (size_t pos = 1; pos < chunked.size(); ++pos)
+        EXPECT_EQ(parse_with_split<String>(chunked, pos), disabled) << pos;
+    for (size_t pos = 1; pos < connect.size(); ++pos)
+        EXPECT_EQ(parse_with_split<String>(connect, pos), disabled) << pos;
+    for (size_t pos = 1; pos < folded.size(); ++pos)
+        EXPECT_EQ(parse_with_split<String>(folded, pos), disabled) << pos;
+    for (size_t pos = 1; pos < folded_empty.size(); ++pos)
+        EXPECT_EQ(parse_with_split<String>(folded_empty, pos), disabled) << pos;
+    for (size_t pos = 1; pos < empty.size(); ++pos)
+        EXPECT_FALSE(parse_with_split<String>(empty, pos)) << pos;
+    // 逐字节输入, 换行和折行的空白落在不同的输入中
+    for (std::string const* s : {&folded, &folded_empty, &empty}) {
+        MinimalParser<String> parser(HTTP_REQUEST);
+        for (size_t i = 0; i < s->size() && !parser.ParseError(); ++i)
+            parser.PartailParse(s->data() + i, 1);
+        EXPECT_EQ(parser.ParseError(), s == &empty ? std::error_code() : disabled) << *s;
+    }
+    for (size_t pos = 1; pos < c_http_request_http_0_9.size(); ++pos)
+        EXPECT_EQ(parse_with_split<String>(c_http_request_http_0_9, pos), disabled) << pos;
+
+    // 关闭upgrade时Upgrade域被当作普通的域
+    MinimalParser<String> parser(HTTP_REQUEST);
+    EXPECT_EQ(parser.PartailParse(upgrade), upgrade.size());
+    EXPECT_TRUE(parser.ParseDone());
+    EXPECT_FALSE(parser.GetDoc().IsUpgrade());
+    EXPECT_EQ(parser.GetDoc().GetBody(), "abc");
+    EXPECT_EQ(parser.GetDoc().GetField("Upgrade"), "websocket");
+
+    // 关闭response时总是解析request
+    EXPECT_TRUE(parser.IsRequest());
+    MinimalParser<String> response_parser(HTTP_RESPONSE);
+    EXPECT_TRUE(response_parser.IsRequest());
+
+    // 默认全部开启
+    TRequestParser<String> full;
+    for (std::string const* s : {&folded_empty, &empty, &upgrade, &chunked, &connect, &folded}) {
+        full.PartailParse(*s);
+        EXPECT_TRUE(full.ParseDone()) << *s;
+        EXPECT_FALSE(full.ParseError()) << *s;
+    }
+    EXPECT_EQ(full.GetDoc().GetField("X-Folded"), "a b");
+}
+
+TEST(parser, features) {
+    test_features<std::string>();
+    test_features<StringRef>();
+#if RAPIDHTTP_HAS_STRING_VIEW
+    test_features<std::string_view>();
+#endif
+}
+
+TEST(parser, fast_request_line) {
+    // 常见的请求行走快速路径, 其它的走http-parser的状态机, 结果要相同
+    std::vector<std::string> lines = {
+        "GET / HTTP/1.1",          "GET /uri/abc?x=1&y=2#frag HTTP/1.1", "POST /a HTTP/1.0",
+        "PUT /a/b/c HTTP/1.1",     "HEAD /abcdefgh HTTP/1.1",            "DELETE /x HTTP/1.1",
+        "PATCH /x HTTP/1.1",       "OPTIONS /x HTTP/1.1",                "OPTIONS * HTTP/1.1",
+        "GET http://a.com/ HTTP/1.1", "PURGE /x HTTP/1.1",               "GET /x HTTP/2.0",
+    };
+    // 和请求行单独用状态机解析的结果比较
+    auto line_of = [](TParser<std::string> const& parser) {
+        auto const& doc = parser.GetDoc();
+        return std::string(http_method_str(doc.GetMethod())) + " " + doc.GetUri() + " HTTP/" +
+               std::to_string(doc.GetMajor()) + "." + std::to_string(doc.GetMinor()) + " " +
+               doc.GetField("Host");
+    };
+    for (auto const& line : lines) {
+        std::string buf = line + "\r\nHost: domain.com\r\n\r\n";
+        TParser<std::string> parser(HTTP_REQUEST);
+        EXPECT_EQ(parser.PartailParse(buf), buf.size()) << line;
+        EXPECT_TRUE(parser.ParseDone()) << line;
+        EXPECT_EQ(line_of(parser), line + " domain.com");
+
+        // 请求行被切断时由状态机继续
+        for (size_t pos = 1; pos < buf.size(); ++pos) {
+            TParser<std::string> split(HTTP_REQUEST);
+            size_t bytes = split.PartailParse(buf.substr(0, pos));
+            bytes += split.PartailParse(buf.substr(bytes));
+            EXPECT_EQ(bytes, buf.size()) << line << " " << pos;
+            EXPECT_EQ(line_of(split), line + " domain.com") << pos;
+        }
+    }
+
+    // 快速路径不接受的字符交给状态机报错
+    for (const char* bad : {"GET /a\x01 HTTP/1.1\r\n\r\n", "GET /a\x7f HTTP/1.1\r\n\r\n",
+                            "GET /\xe4\xb8\xad HTTP/1.1\r\n\r\n", "GET /a HTTP/1.1\r\r\n\r\n",
+                            "GETX /x HTTP/1.1\r\n\r\n"}) {
+        TParser<std::string> parser(HTTP_REQUEST);
+        parser.PartailParse(bad);
+        EXPECT_TRUE(!!parser.ParseError()) << bad;
+    }
+}
+
+TEST(parser, header_prescan) {
+    // 每次多收到一个字节, 调用方保留没有被消耗的数据
+    std::string buf = c_http_request;
+    TParser<StringRef> parser(HTTP_REQUEST);
+    parser.SetHeaderPrescan(true);
+    size_t header_size = buf.find("\r\n\r\n") + 4;
+    size_t consumed = 0;
+    std::string pending;
+    for (size_t pos = 0; pos < buf.size(); ++pos) {
+        pending.push_back(buf[pos]);
+        size_t bytes = parser.PartailParse(pending);
+        EXPECT_FALSE(parser.ParseError()) << pos;
+        // 头部完整之前不消耗任何数据
+        if (pos + 1 < header_size) {
+            EXPECT_EQ(bytes, 0u) << pos;
+        }
+        consumed += bytes;
+        if (parser.ParseDone()) break;
+        pending.erase(0, bytes);
+    }
+    EXPECT_EQ(consumed, buf.size());
+    EXPECT_TRUE(parser.ParseDone());
+    EXPECT_EQ(parser.GetDoc().SerializeAsString(), buf);
+
+    // 头部的值直接引用最后一次传入的缓冲区, 不需要拼接
+    StringRef const& host = parser.GetDoc().GetField("Host");
+    EXPECT_EQ(host, "domain.com");
+    EXPECT_TRUE(host.data() >= pending.data() && host.data() < pending.data() + pending.size());
+
+    // 只有LF的换行
+    std::string lf = "GET /a HTTP/1.1\nHost: x\n\n";
+    TParser<std::string> lf_parser(HTTP_REQUEST);
+    lf_parser.SetHeaderPrescan(true);
+    EXPECT_EQ(lf_parser.PartailParse(lf.substr(0, lf.size() - 1)), 0u);
+    EXPECT_EQ(lf_parser.PartailParse(lf), lf.size());
+    EXPECT_TRUE(lf_parser.ParseDone());
+    EXPECT_EQ(lf_parser.GetDoc().GetField("Host"), "x");
+
+    // 超过长度上限的头部交给状态机报错
+    TParser<std::string> big(HTTP_REQUEST);
+    big.SetHeaderPrescan(true);
+    std::string long_header = "GET / HTTP/1.1\r\nX: " + std::string(HTTP_MAX_HEADER_SIZE, 'a');
+    big.PartailParse(long_header);
+    EXPECT_TRUE(!!big.ParseError());
+}
+
+TEST(parser, expected_bytes) {
+    // Content-Length: 剩余的长度
+    std::string identity = "POST /a HTTP/1.1\r\nContent-Length: 10\r\n\r\n0123456789";
+    size_t header_size = identity.size() - 10;
+    TParser<std::string> parser(HTTP_REQUEST);
+    EXPECT_EQ(parser.ExpectedBytes(), 1u);
+    parser.PartailParse(identity.substr(0, header_size - 1));
+    EXPECT_EQ(parser.ExpectedBytes(), 1u);
+    parser.PartailParse(identity.substr(header_size - 1, 1));
+    EXPECT_EQ(parser.ExpectedBytes(), 10u);
+    parser.PartailParse(identity.substr(header_size, 4));
+    EXPECT_EQ(parser.ExpectedBytes(), 6u);
+    parser.PartailParse(identity.substr(header_size + 4));
+    EXPECT_TRUE(parser.ParseDone());
+    EXPECT_EQ(parser.ExpectedBytes(), 0u);
+
+    // chunked: 当前块的剩余部分, 块尾的CRLF和最后一块
+    std::string chunked = "PUT /a HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n";
+    TParser<std::string> chunk_parser(HTTP_REQUEST);
+    chunk_parser.PartailParse(chunked);
+    EXPECT_EQ(chunk_parser.ExpectedBytes(), 1u);
+    chunk_parser.PartailParse("a\r\n01234");
+    EXPECT_EQ(chunk_parser.ExpectedBytes(), 5u + 2 + 5);
+    chunk_parser.PartailParse("56789");
+    EXPECT_EQ(chunk_parser.ExpectedBytes(), 2u + 5);
+    chunk_parser.PartailParse("\r");
+    EXPECT_EQ(chunk_parser.ExpectedBytes(), 1u + 5);
+    chunk_parser.PartailParse("\n0\r\n\r\n");
+    EXPECT_TRUE(chunk_parser.ParseDone());
+    EXPECT_EQ(chunk_parser.ExpectedBytes(), 0u);
+
+    // 出错之后不再需要数据
+    TParser<std::string> error_parser(HTTP_REQUEST);
+    error_parser.PartailParse("POST/uri/abc HTTP/1.1\r\n\r\n");
+    EXPECT_EQ(error_parser.ExpectedBytes(), 0u);
+}
+
+template <typename Parser>
+void test_body_destination() {
+    std::string head = "POST /upload HTTP/1.1\r\nContent-Length: 10\r\n\r\n";
+    std::string body = "0123456789";
+
+    // 头部之后已经收到3字节body
+    std::string first = head + body.substr(0, 3);
+    Parser parser(HTTP_REQUEST);
+    char dest[10] = {};
+    EXPECT_FALSE(parser.SetBodyDestination(dest, sizeof(dest)));
+    EXPECT_EQ(parser.PartailParse(first), first.size());
+    EXPECT_TRUE(parser.HeadersDone());
+    EXPECT_EQ(parser.ExpectedBytes(), 7u);
+    EXPECT_FALSE(parser.SetBodyDestination(dest, 9));
+    EXPECT_TRUE(parser.SetBodyDestination(dest, sizeof(dest)));
+    EXPECT_EQ(parser.BodyPlaced(), 3u);
+    EXPECT_EQ(std::string(dest, 3), "012");
+
+    // recv直接写入目标缓冲区
+    memcpy(dest + parser.BodyPlaced(), body.data() + 3, 4);
+    EXPECT_EQ(parser.CommitBody(4), 4u);
+    EXPECT_EQ(parser.ExpectedBytes(), 3u);
+    EXPECT_FALSE(parser.ParseDone());
+
+    // 通过PartailParse传入的仍然会放到目标缓冲区
+    EXPECT_EQ(parser.PartailParse(body.substr(7, 1)), 1u);
+    EXPECT_EQ(parser.BodyPlaced(), 8u);
+
+    // 超过body的部分不会被接受
+    memcpy(dest + parser.BodyPlaced(), body.data() + 8, 2);
+    EXPECT_EQ(parser.CommitBody(5), 2u);
+    EXPECT_TRUE(parser.ParseDone());
+    EXPECT_FALSE(parser.ParseError());
+    EXPECT_EQ(std::string(dest, sizeof(dest)), body);
+    EXPECT_TRUE(parser.GetDoc().GetBody().empty());
+
+    // 下一个消息照常存入document
+    std::string next = head + body;
+    EXPECT_EQ(parser.PartailParse(next), next.size());
+    EXPECT_EQ(parser.GetDoc().GetBody(), body);
+
+    // chunked不能直接放置
+    Parser chunk_parser(HTTP_REQUEST);
+    chunk_parser.PartailParse("PUT /a HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n");
+    EXPECT_TRUE(chunk_parser.HeadersDone());
+    EXPECT_FALSE(chunk_parser.SetBodyDestination(dest, sizeof(dest)));
+}
+
+TEST(parser, body_destination) {
+    test_body_destination<TParser<std::string>>();
+    test_body_destination<TParser<StringRef>>();
+    test_body_destination<TParser<std::string, AllFields, AllFeatures, DfaEngine>>();
+}
@@ -188,5 +188,52 @@ static void copyto_response() {
 TEST(parser, response) {
     test_parse_response<std::string>();
     test_parse_response<StringRef>();
+#if RAPIDHTTP_HAS_STRING_VIEW
+    test_parse_response<std::string_view>();
+#endif
     copyto_response();
 }
+
+template <typename String>
+static void test_field_range() {
+    std::string buf =
+        "HTTP/1.1 200 OK\r\n"
+        "Set-Cookie: a=1; Expires=Wed, 21 Oct 2015 07:28:00 GMT\r\n"
+        "Via: 1.1 proxy-a, 1.0 \"proxy, b\"\r\n"
+        "set-cookie: b=2\r\n"
+        "VIA: ,, 1.1 proxy-c ,\r\n"
+        "Content-Length: 0\r\n"
+        "\r\n";
+    TResponseParser<String> parser;
+    EXPECT_EQ(parser.PartailParse(buf), buf.size());
+    auto const& doc = parser.GetDoc();
+
+    // Set-Cookie不是列表域, 按整个值遍历
+    std::vector<std::string> values;
+    for (auto const& value : doc.GetFieldValues("Set-Cookie")) values.emplace_back(value);
+    ASSERT_EQ(values.size(), 2);
+    EXPECT_EQ(values[0], "a=1; Expires=Wed, 21 Oct 2015 07:28:00 GMT");
+    EXPECT_EQ(values[1], "b=2");
+    EXPECT_EQ(doc.GetFieldValues("set-cookie").Count(), 2);
+    EXPECT_TRUE(doc.GetFieldValues("X-Missing").Empty());
+    // 指向document中的域
+    EXPECT_EQ(&*doc.GetFieldValues("SET-COOKIE").begin(), &doc.GetFields()[0].second);
+
+    std::vector<std::string> elements;
+    for (auto const& element : doc.GetFieldElements("via")) elements.emplace_back(element);
+    ASSERT_EQ(elements.size(), 3);
+    EXPECT_EQ(elements[0], "1.1 proxy-a");
+    EXPECT_EQ(elements[1], "1.0 \"proxy, b\"");
+    EXPECT_EQ(elements[2], "1.1 proxy-c");
+    EXPECT_TRUE(doc.GetFieldElements("Via").Contains("1.1 PROXY-C"));
+    EXPECT_FALSE(doc.GetFieldElements("Via").Contains("proxy-a"));
+    EXPECT_TRUE(doc.GetFieldElements("X-Missing").begin() == doc.GetFieldElements("X-Missing").end());
+}
+
+TEST(parser, field_range) {
+    test_field_range<std::string>();
+    test_field_range<StringRef>();
+#if RAPIDHTTP_HAS_STRING_VIEW
+    test_field_range<std::string_view>();
+#endif
+}
@@ -0,0 +1,125 @@
+#include <gtest/gtest.h>
+#include <rapidhttp/pull_parser.h>
+
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace rapidhttp;
+
+static std::string c_http_request =
+    "POST /uri/abc?x=1 HTTP/1.1\r\n"
+    "Host: domain.com\r\n"
+    "Accept: XAccept\r\n"
+    "Content-Length: 3\r\n"
+    "\r\nabc";
+
+static const std::vector<std::string> c_request_tokens = {
+    "request:POST /uri/abc?x=1 1.1", "Host=domain.com", "Accept=XAccept", "Content-Length=3",
+    "headers", "body:abc", "complete"};
+
+// 拉取全部token, 记录成字符串; 相邻的body合并
+static void Drain(PullParser& parser, std::vector<std::string>& out) {
+    for (;;) {
+        PullToken const& token = parser.Next();
+        switch (token.type) {
+            case PullToken::kNeedMore:
+                return;
+            case PullToken::kRequestLine:
+                out.push_back(std::string("request:") + http_method_str(token.method) + " " +
+                              std::string(token.first) + " " + std::to_string(token.major) + "." +
+                              std::to_string(token.minor));
+                break;
+            case PullToken::kStatusLine:
+                out.push_back("status:" + std::to_string(token.status_code) + " " +
+                              std::string(token.first));
+                break;
+            case PullToken::kHeader:
+                out.push_back(std::string(token.first) + "=" + std::string(token.second));
+                break;
+            case PullToken::kHeadersComplete:
+                out.push_back("headers");
+                break;
+            case PullToken::kBody:
+                if (out.empty() || out.back().compare(0, 5, "body:") != 0) out.push_back("body:");
+                out.back() += std::string(token.first);
+                break;
+            case PullToken::kMessageComplete:
+                out.push_back("complete");
+                break;
+            case PullToken::kError:
+                out.push_back("error");
+                return;
+        }
+    }
+}
+
+TEST(pull_parser, request) {
+    PullParser parser(HTTP_REQUEST);
+    parser.Feed(c_http_request);
+
+    // token直接引用输入缓冲区
+    PullToken const& token = parser.Next();
+    EXPECT_EQ(token.type, PullToken::kRequestLine);
+    EXPECT_EQ(token.method, HTTP_POST);
+    EXPECT_EQ(token.first.data(), c_http_request.c_str() + 5);
+    EXPECT_EQ(parser.Next().type, PullToken::kHeader);
+
+    PullParser parser2(HTTP_REQUEST);
+    parser2.Feed(c_http_request);
+    std::vector<std::string> tokens;
+    Drain(parser2, tokens);
+    EXPECT_EQ(tokens, c_request_tokens);
+    EXPECT_TRUE(parser2.ParseDone());
+    EXPECT_FALSE(parser2.ParseError());
+}
+
+TEST(pull_parser, split) {
+    // 任意位置切开, 每一段放在独立的缓冲区中, kNeedMore之后立即销毁
+    for (size_t pos = 1; pos < c_http_request.size(); ++pos) {
+        PullParser parser(HTTP_REQUEST);
+        std::vector<std::string> tokens;
+        std::string* first = new std::string(c_http_request.substr(0, pos));
+        parser.Feed(*first);
+        Drain(parser, tokens);
+        delete first;
+        std::string second = c_http_request.substr(pos);
+        parser.Feed(second);
+        Drain(parser, tokens);
+        EXPECT_EQ(tokens, c_request_tokens) << pos;
+        EXPECT_TRUE(parser.ParseDone()) << pos;
+    }
+}
+
+TEST(pull_parser, pipeline) {
+    std::string response =
+        "HTTP/1.1 200 OK\r\n"
+        "Transfer-Encoding: chunked\r\n"
+        "\r\n"
+        "3\r\nabc\r\n2\r\nde\r\n0\r\n\r\n"
+        "HTTP/1.1 404 Not Found\r\n"
+        "\r\n";
+    PullParser parser(HTTP_RESPONSE);
+    parser.Feed(response);
+    std::vector<std::string> tokens;
+    Drain(parser, tokens);
+    std::vector<std::string> expect = {"status:200 OK", "Transfer-Encoding=chunked", "headers",
+                                       "body:abcde", "complete", "status:404 Not Found",
+                                       "headers"};
+    EXPECT_EQ(tokens, expect);
+    EXPECT_FALSE(parser.ParseDone());
+
+    // 没有Content-Length的response读取到链接断开为止
+    parser.FeedEof();
+    Drain(parser, tokens);
+    EXPECT_EQ(tokens.back(), "complete");
+    EXPECT_TRUE(parser.ParseDone());
+}
+
+TEST(pull_parser, error) {
+    PullParser parser(HTTP_REQUEST);
+    parser.Feed("POST/uri/abc HTTP/1.1\r\n\r\n");
+    EXPECT_EQ(parser.Next().type, PullToken::kError);
+    EXPECT_TRUE(!!parser.ParseError());
+    EXPECT_EQ(parser.Next().type, PullToken::kError);
+}
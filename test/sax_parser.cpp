@@ -0,0 +1,121 @@
+#include <gtest/gtest.h>
+#include <rapidhttp/sax_parser.h>
+
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace rapidhttp;
+
+// 把事件按顺序记录成字符串, 方便比较
+struct RecordHandler : SaxHandler {
+    std::vector<std::string> events;
+    std::string body;
+
+    void on_method(http_method m) { events.push_back(std::string("method:") + http_method_str(m)); }
+    void on_uri(StringRef const& uri) { events.push_back("uri:" + std::string(uri)); }
+    void on_status(int code, StringRef const& reason) {
+        events.push_back("status:" + std::to_string(code) + " " + std::string(reason));
+    }
+    void on_header(StringRef const& name, StringRef const& value) {
+        events.push_back(std::string(name) + "=" + std::string(value));
+    }
+    void on_headers_complete(int major, int minor) {
+        events.push_back("version:" + std::to_string(major) + "." + std::to_string(minor));
+    }
+    void on_body(const char* at, size_t length) { body.append(at, length); }
+    void on_message_complete() { events.push_back("complete"); }
+};
+
+static std::string c_http_request =
+    "POST /uri/abc?x=1 HTTP/1.1\r\n"
+    "Host: domain.com\r\n"
+    "Accept: XAccept\r\n"
+    "Content-Length: 3\r\n"
+    "\r\nabc";
+
+static const std::vector<std::string> c_request_events = {
+    "method:POST", "uri:/uri/abc?x=1", "Host=domain.com", "Accept=XAccept",
+    "Content-Length=3", "version:1.1", "complete"};
+
+TEST(sax_parser, request) {
+    TSaxParser<RecordHandler> parser(HTTP_REQUEST);
+    size_t bytes = parser.PartailParse(c_http_request);
+    EXPECT_EQ(bytes, c_http_request.size());
+    EXPECT_FALSE(parser.ParseError());
+    EXPECT_TRUE(parser.ParseDone());
+    EXPECT_EQ(parser.GetHandler().events, c_request_events);
+    EXPECT_EQ(parser.GetHandler().body, "abc");
+}
+
+TEST(sax_parser, split) {
+    // 任意位置切开, 每一段放在独立的缓冲区中, 解析后立即销毁
+    for (size_t pos = 1; pos < c_http_request.size(); ++pos) {
+        TSaxParser<RecordHandler> parser(HTTP_REQUEST);
+        std::string* first = new std::string(c_http_request.substr(0, pos));
+        size_t bytes = parser.PartailParse(*first);
+        delete first;
+        std::string second = c_http_request.substr(bytes);
+        bytes += parser.PartailParse(second);
+        EXPECT_EQ(bytes, c_http_request.size()) << pos;
+        EXPECT_TRUE(parser.ParseDone()) << pos;
+        EXPECT_EQ(parser.GetHandler().events, c_request_events) << pos;
+        EXPECT_EQ(parser.GetHandler().body, "abc") << pos;
+    }
+}
+
+TEST(sax_parser, response) {
+    std::string response =
+        "HTTP/1.1 404 Not Found\r\n"
+        "Transfer-Encoding: chunked\r\n"
+        "\r\n"
+        "3\r\nabc\r\n2\r\nde\r\n0\r\n\r\n";
+    TSaxParser<RecordHandler> parser(HTTP_RESPONSE);
+    EXPECT_EQ(parser.PartailParse(response), response.size());
+    EXPECT_TRUE(parser.ParseDone());
+    std::vector<std::string> events = {"status:404 Not Found", "Transfer-Encoding=chunked",
+                                       "version:1.1", "complete"};
+    EXPECT_EQ(parser.GetHandler().events, events);
+    EXPECT_EQ(parser.GetHandler().body, "abcde");
+
+    // 解析完成后再次解析会自动Reset, Handler保留
+    parser.GetHandler().events.clear();
+    EXPECT_EQ(parser.PartailParse(response), response.size());
+    EXPECT_EQ(parser.GetHandler().events, events);
+}
+
+TEST(sax_parser, pipeline) {
+    // 同一块缓冲区中的多个请求, 每个请求的事件都完整
+    std::string first = "GET /a HTTP/1.1\r\nHost: a\r\n\r\n";
+    std::string second = "POST /b HTTP/1.1\r\nContent-Length: 2\r\n\r\nxy";
+    std::vector<std::string> events = {"method:GET", "uri:/a", "Host=a", "version:1.1",
+                                       "complete", "method:POST", "uri:/b",
+                                       "Content-Length=2", "version:1.1", "complete"};
+
+    std::string buf = first + second;
+    TSaxParser<RecordHandler> parser(HTTP_REQUEST);
+    EXPECT_EQ(parser.PartailParse(buf), buf.size());
+    EXPECT_TRUE(parser.ParseDone());
+    EXPECT_EQ(parser.GetHandler().events, events);
+    EXPECT_EQ(parser.GetHandler().body, "xy");
+
+    // 第二个请求被切断在任意位置
+    for (size_t pos = first.size() + 1; pos < buf.size(); ++pos) {
+        TSaxParser<RecordHandler> parser(HTTP_REQUEST);
+        size_t bytes = parser.PartailParse(buf.data(), pos);
+        EXPECT_EQ(bytes, pos);
+        EXPECT_FALSE(parser.ParseDone()) << pos;
+        bytes += parser.PartailParse(buf.substr(bytes));
+        EXPECT_EQ(bytes, buf.size()) << pos;
+        EXPECT_TRUE(parser.ParseDone()) << pos;
+        EXPECT_EQ(parser.GetHandler().events, events) << pos;
+        EXPECT_EQ(parser.GetHandler().body, "xy") << pos;
+    }
+}
+
+TEST(sax_parser, error) {
+    TSaxParser<SaxHandler> parser(HTTP_REQUEST);
+    parser.PartailParse("POST/uri/abc HTTP/1.1\r\n\r\n");
+    EXPECT_TRUE(!!parser.ParseError());
+    EXPECT_FALSE(parser.ParseDone());
+}
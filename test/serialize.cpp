@@ -0,0 +1,436 @@
+#include <gtest/gtest.h>
+#include <rapidhttp/parser.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "rapidhttp/date_cache.h"
+#include "rapidhttp/output_chain.h"
+#include "rapidhttp/response_template.h"
+#include "rapidhttp/serialize_cursor.h"
+#include "rapidhttp/stringref.h"
+
+using namespace std;
+using namespace rapidhttp;
+
+static std::string c_http_request =
+    "POST /uri/abc HTTP/1.1\r\n"
+    "Accept: XAccept\r\n"
+    "Host: domain.com\r\n"
+    "Content-Length: 3\r\n"
+    "\r\nabc";
+
+static std::string c_http_response =
+    "HTTP/1.1 404 Not Found\r\n"
+    "Server: rapidhttp\r\n"
+    "Content-Length: 5\r\n"
+    "\r\nhello";
+
+static std::string JoinIovec(const struct iovec* iov, size_t n) {
+    std::string s;
+    for (size_t i = 0; i < n; ++i) s.append((const char*)iov[i].iov_base, iov[i].iov_len);
+    return s;
+}
+
+template <typename String>
+static void test_serialize_iovec() {
+    struct iovec iov[32];
+
+    TRequestParser<String> req_parser;
+    size_t bytes = req_parser.PartailParse(c_http_request);
+    EXPECT_EQ(bytes, c_http_request.size());
+    EXPECT_TRUE(req_parser.ParseDone());
+    auto const& request = req_parser.GetDoc();
+    size_t n = request.SerializeToIovec(iov, 32);
+    EXPECT_EQ(n, request.IovecCount());
+    EXPECT_EQ(JoinIovec(iov, n), c_http_request);
+    EXPECT_EQ(request.SerializeToIovec(iov, request.IovecCount() - 1), 0);
+
+    TResponseParser<String> res_parser;
+    bytes = res_parser.PartailParse(c_http_response);
+    EXPECT_EQ(bytes, c_http_response.size());
+    EXPECT_TRUE(res_parser.ParseDone());
+    auto const& response = res_parser.GetDoc();
+    n = response.SerializeToIovec(iov, 32);
+    EXPECT_EQ(n, response.IovecCount());
+    EXPECT_EQ(JoinIovec(iov, n), c_http_response);
+
+    // body指向原字符串, 不发生拷贝
+    EXPECT_EQ((const char*)iov[n - 1].iov_base, response.GetBody().data());
+
+    // 没有域也没有body
+    TDocument<String> doc(HTTP_RESPONSE);
+    doc.SetStatus(204, "No Content");
+    doc.SetVersion(10);
+    n = doc.SerializeToIovec(iov, 32);
+    EXPECT_EQ(n, doc.IovecCount());
+    EXPECT_EQ(JoinIovec(iov, n), doc.SerializeAsString());
+    EXPECT_EQ(JoinIovec(iov, n), "HTTP/1.0 204 No Content\r\n\r\n");
+
+    // 未初始化的document
+    TDocument<String> empty(HTTP_REQUEST);
+    EXPECT_EQ(empty.SerializeToIovec(iov, 32), 0);
+}
+
+template <typename String>
+static void test_serialize_cache() {
+    TDocument<String> doc(HTTP_RESPONSE);
+    doc.SetStatus(200, "OK");
+    doc.SetField("Server", "rapidhttp");
+    doc.SetField("Content-Length", "5");
+    doc.SetBody("hello");
+
+    std::string expect =
+        "HTTP/1.1 200 OK\r\n"
+        "Server: rapidhttp\r\n"
+        "Content-Length: 5\r\n"
+        "\r\nhello";
+
+    // 序列化不会填充缓存, 只有PrepareCache才会
+    EXPECT_EQ(doc.SerializeAsString(), expect);
+    EXPECT_EQ(doc.SerializeAsString(), expect);
+    EXPECT_GT(doc.IovecCount(), 2);
+    EXPECT_TRUE(doc.PrepareCache());
+    EXPECT_EQ(doc.IovecCount(), 3);  // 缓存的起始行 + 缓存的域 + body
+    EXPECT_EQ(doc.ByteSize(), expect.size());
+    for (int i = 0; i < 3; ++i) EXPECT_EQ(doc.SerializeAsString(), expect);
+
+    struct iovec iov[16];
+    size_t n = doc.SerializeToIovec(iov, 16);
+    EXPECT_EQ(n, 3);
+    EXPECT_EQ(JoinIovec(iov, n), expect);
+    // body不进入缓存, 直接引用document中的body
+    EXPECT_EQ(iov[2].iov_base, (void*)doc.GetBody().data());
+
+    // 修改后只重新生成失效的部分
+    doc.SetField("Content-Length", "11");
+    doc.SetBody("hello world");
+    expect =
+        "HTTP/1.1 200 OK\r\n"
+        "Server: rapidhttp\r\n"
+        "Content-Length: 11\r\n"
+        "\r\nhello world";
+    EXPECT_EQ(doc.ByteSize(), expect.size());
+    EXPECT_EQ(doc.SerializeAsString(), expect);
+    EXPECT_EQ(doc.SerializeAsString(), expect);
+
+    doc.SetStatus(404, "Not Found");
+    expect =
+        "HTTP/1.1 404 Not Found\r\n"
+        "Server: rapidhttp\r\n"
+        "Content-Length: 11\r\n"
+        "\r\nhello world";
+    EXPECT_EQ(doc.ByteSize(), expect.size());
+    EXPECT_EQ(doc.SerializeAsString(), expect);
+    EXPECT_EQ(doc.SerializeAsString(), expect);
+    EXPECT_EQ(doc.SerializeAsString(), expect);
+
+    doc.SetBody("");
+    doc.SetVersion(10);
+    expect =
+        "HTTP/1.0 404 Not Found\r\n"
+        "Server: rapidhttp\r\n"
+        "Content-Length: 11\r\n"
+        "\r\n";
+    EXPECT_EQ(doc.SerializeAsString(), expect);
+    EXPECT_EQ(doc.SerializeAsString(), expect);
+
+    // 缓冲区不足
+    char buf[16];
+    EXPECT_FALSE(doc.Serialize(buf, sizeof(buf)));
+
+    // 修改body不影响缓存
+    EXPECT_TRUE(doc.PrepareCache());
+    doc.SetBody("hi");
+    EXPECT_EQ(doc.IovecCount(), 3);
+    EXPECT_EQ(doc.SerializeAsString(), expect + "hi");
+
+    doc.Reset();
+    EXPECT_FALSE(doc.PrepareCache());
+    EXPECT_EQ(doc.ByteSize(), 0);
+    EXPECT_EQ(doc.SerializeAsString(), "");
+}
+
+template <typename String>
+static void test_serialize_cursor() {
+    TResponseParser<String> parser;
+    size_t bytes = parser.PartailParse(c_http_response);
+    EXPECT_EQ(bytes, c_http_response.size());
+    auto const& response = parser.GetDoc();
+
+    // 任意大小的输出缓冲区, 分多次写完
+    for (size_t len = 1; len <= c_http_response.size() + 1; ++len) {
+        TSerializeCursor<String> cursor(response);
+        EXPECT_EQ(cursor.ByteSize(), c_http_response.size());
+        std::string output;
+        std::vector<char> buf(len);
+        while (!cursor.Done()) {
+            size_t n = cursor.Serialize(buf.data(), len);
+            EXPECT_GT(n, 0);
+            EXPECT_LE(n, len);
+            output.append(buf.data(), n);
+            EXPECT_EQ(cursor.Written(), output.size());
+        }
+        EXPECT_EQ(cursor.Remaining(), 0);
+        EXPECT_EQ(cursor.Serialize(buf.data(), len), 0);
+        EXPECT_EQ(output, c_http_response);
+    }
+
+    // 使用序列化缓存
+    TDocument<String> doc(HTTP_REQUEST);
+    doc.SetMethod(HTTP_GET).SetUri("/index.html").SetField("Host", "domain.com");
+    std::string expect = doc.SerializeAsString();
+    EXPECT_TRUE(doc.PrepareCache());
+    EXPECT_EQ(doc.IovecCount(), 2);
+
+    TSerializeCursor<String> cursor(doc);
+    std::string output;
+    char buf[7];
+    while (!cursor.Done()) output.append(buf, cursor.Serialize(buf, sizeof(buf)));
+    EXPECT_EQ(output, expect);
+
+    // 未初始化的document
+    TDocument<String> empty(HTTP_REQUEST);
+    cursor.Reset(empty);
+    EXPECT_TRUE(cursor.Done());
+    EXPECT_EQ(cursor.Serialize(buf, sizeof(buf)), 0);
+}
+
+template <typename String>
+static void test_serialize_output_chain() {
+    TResponseParser<String> parser;
+    size_t bytes = parser.PartailParse(c_http_response);
+    EXPECT_EQ(bytes, c_http_response.size());
+    auto const& response = parser.GetDoc();
+
+    // 小块便于覆盖跨块的情况
+    OutputBlockPool pool(64);
+    OutputChain chain(pool);
+    std::string expect;
+    for (int i = 0; i < 10; ++i) {
+        EXPECT_TRUE(chain.Append(response));
+        expect += c_http_response;
+    }
+    chain.Append("tail", 4);
+    expect += "tail";
+    EXPECT_EQ(chain.ByteSize(), expect.size());
+    EXPECT_EQ(chain.BlockCount(), (expect.size() + 63) / 64);
+
+    struct iovec iov[32];
+    size_t n = chain.ToIovec(iov, 32);
+    EXPECT_EQ(n, chain.BlockCount());
+    EXPECT_EQ(JoinIovec(iov, n), expect);
+
+    // 模拟writev部分写入
+    chain.Consume(100);
+    expect = expect.substr(100);
+    n = chain.ToIovec(iov, 32);
+    EXPECT_EQ(JoinIovec(iov, n), expect);
+    EXPECT_EQ(pool.FreeBlocks(), 1);
+
+    chain.Consume(expect.size());
+    EXPECT_TRUE(chain.Empty());
+    EXPECT_EQ(chain.ToIovec(iov, 32), 0);
+
+    // 缓冲块被复用, 不再分配
+    size_t free_blocks = pool.FreeBlocks();
+    EXPECT_TRUE(chain.Append(response));
+    EXPECT_EQ(pool.FreeBlocks(), free_blocks - 1);
+    n = chain.ToIovec(iov, 32);
+    EXPECT_EQ(JoinIovec(iov, n), c_http_response);
+
+    TDocument<String> empty(HTTP_REQUEST);
+    EXPECT_FALSE(chain.Append(empty));
+
+    chain.Clear();
+    EXPECT_TRUE(chain.Empty());
+    EXPECT_EQ(chain.BlockCount(), 0);
+}
+
+static constexpr auto c_health_template = MakeResponseTemplate(
+    RAPIDHTTP_STATUS_LINE(200, "OK") "Server: rapidhttp\r\nContent-Length: ", "\r\n\r\n", "");
+static constexpr auto c_not_modified_template =
+    MakeResponseTemplate(RAPIDHTTP_STATUS_LINE(304, "Not Modified") "ETag: \"", "\"\r\n\r\n");
+
+static_assert(c_health_template.FixedSize() == 56, "pre-rendered at compile time");
+
+TEST(serialize, response_template) {
+    std::string body = "hello";
+    std::string expect =
+        "HTTP/1.1 200 OK\r\n"
+        "Server: rapidhttp\r\n"
+        "Content-Length: 5\r\n"
+        "\r\nhello";
+    EXPECT_EQ(c_health_template.ByteSize(body.size(), body), expect.size());
+    EXPECT_EQ(c_health_template.SerializeAsString(body.size(), body), expect);
+
+    char buf[128];
+    EXPECT_TRUE(c_health_template.Serialize(buf, sizeof(buf), body.size(), body));
+    EXPECT_EQ(std::string(buf, expect.size()), expect);
+    EXPECT_FALSE(c_health_template.Serialize(buf, expect.size() - 1, body.size(), body));
+
+    // 与TDocument序列化结果一致
+    Document doc(HTTP_RESPONSE);
+    doc.SetStatus(200, "OK").SetField("Server", "rapidhttp").SetField("Content-Length", "5");
+    doc.SetBody(body);
+    EXPECT_EQ(doc.SerializeAsString(), expect);
+
+    // 各种类型的槽位值
+    EXPECT_EQ(c_health_template.SerializeAsString(0, ""),
+              "HTTP/1.1 200 OK\r\nServer: rapidhttp\r\nContent-Length: 0\r\n\r\n");
+    EXPECT_EQ(c_health_template.SerializeAsString(12345678901ull, StringRef("x")),
+              "HTTP/1.1 200 OK\r\nServer: rapidhttp\r\nContent-Length: 12345678901\r\n\r\nx");
+    EXPECT_EQ(c_not_modified_template.SerializeAsString("abc"),
+              "HTTP/1.1 304 Not Modified\r\nETag: \"abc\"\r\n\r\n");
+}
+
+TEST(serialize, iovec) {
+    test_serialize_iovec<std::string>();
+    test_serialize_iovec<StringRef>();
+#if RAPIDHTTP_HAS_STRING_VIEW
+    test_serialize_iovec<std::string_view>();
+#endif
+}
+
+TEST(serialize, cache) {
+    test_serialize_cache<std::string>();
+    test_serialize_cache<StringRef>();
+#if RAPIDHTTP_HAS_STRING_VIEW
+    test_serialize_cache<std::string_view>();
+#endif
+}
+
+TEST(serialize, cursor) {
+    test_serialize_cursor<std::string>();
+    test_serialize_cursor<StringRef>();
+#if RAPIDHTTP_HAS_STRING_VIEW
+    test_serialize_cursor<std::string_view>();
+#endif
+}
+
+TEST(serialize, output_chain) {
+    test_serialize_output_chain<std::string>();
+    test_serialize_output_chain<StringRef>();
+#if RAPIDHTTP_HAS_STRING_VIEW
+    test_serialize_output_chain<std::string_view>();
+#endif
+}
+
+TEST(serialize, concurrent) {
+    // 准备好缓存的response在多个线程中同时序列化
+    Document doc(HTTP_RESPONSE);
+    doc.SetStatus(200, "OK").SetField("Server", "rapidhttp").SetField("Content-Length", "5");
+    doc.SetBody("hello");
+    std::string expect = doc.SerializeAsString();
+    ASSERT_TRUE(doc.PrepareCache());
+
+    // 带Date域时缓存也是只读的, 各线程的Date域来自自己的快照
+    Document dated(doc);
+    dated.SetDateField();
+    ASSERT_TRUE(dated.PrepareCache());
+    size_t start_size = strlen("HTTP/1.1 200 OK\r\n");
+
+    std::atomic<int> errors{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&] {
+            struct iovec iov[16];
+            for (int i = 0; i < 1000; ++i) {
+                if (doc.SerializeAsString() != expect) ++errors;
+                if (JoinIovec(iov, doc.SerializeToIovec(iov, 16)) != expect) ++errors;
+
+                std::string s = JoinIovec(iov, dated.SerializeToIovec(iov, 16));
+                if (s.size() != expect.size() + DateCache::c_line_size ||
+                    s.compare(start_size, 6, "Date: ") != 0 ||
+                    s.substr(start_size + DateCache::c_line_size) != expect.substr(start_size))
+                    ++errors;
+            }
+        });
+    }
+    for (auto& t : threads) t.join();
+    EXPECT_EQ(errors, 0);
+}
+
+TEST(serialize, cursor_date) {
+    // 在Date域中间断开, 之间当前线程的快照被刷新, 之后换一个线程继续写
+    for (bool cached : {false, true}) {
+        Document doc(HTTP_RESPONSE);
+        doc.SetStatus(200, "OK").SetField("Content-Length", "5").SetDateField();
+        doc.SetBody("hello");
+        if (cached) {
+            EXPECT_TRUE(doc.PrepareCache());
+        }
+        std::string start = "HTTP/1.1 200 OK\r\n";
+        std::string rest = "Content-Length: 5\r\n\r\nhello";
+
+        SerializeCursor cursor(doc);
+        char buf[256];
+        size_t n = cursor.Serialize(buf, start.size() + 10);
+        EXPECT_EQ(n, start.size() + 10);
+        std::string output(buf, n);
+
+        DateCache::Instance().Line(784111777);
+        std::thread([&] {
+            while (!cursor.Done()) output.append(buf, cursor.Serialize(buf, 7));
+        }).join();
+
+        ASSERT_EQ(output.size(), start.size() + DateCache::c_line_size + rest.size()) << cached;
+        std::string date = output.substr(start.size(), DateCache::c_line_size);
+        EXPECT_EQ(output.substr(0, start.size()), start) << cached;
+        EXPECT_EQ(date.substr(0, 6), "Date: ") << cached;
+        EXPECT_EQ(date.find("1994"), std::string::npos) << date;
+        EXPECT_EQ(date.substr(DateCache::c_line_size - 6), " GMT\r\n") << cached;
+        EXPECT_EQ(output.substr(start.size() + DateCache::c_line_size), rest) << cached;
+    }
+}
+
+TEST(serialize, date) {
+    char buf[64];
+    EXPECT_EQ(DateCache::Format(784111777, buf), buf + DateCache::c_line_size);
+    EXPECT_EQ(std::string(buf, DateCache::c_line_size), "Date: Sun, 06 Nov 1994 08:49:37 GMT\r\n");
+    EXPECT_EQ(std::string(DateCache::Instance().Line(784111777), DateCache::c_line_size),
+              "Date: Sun, 06 Nov 1994 08:49:37 GMT\r\n");
+
+    Document doc(HTTP_RESPONSE);
+    doc.SetStatus(200, "OK").SetField("Content-Length", "5").SetDateField();
+    doc.SetBody("hello");
+    std::string start = "HTTP/1.1 200 OK\r\n";
+    std::string rest = "Content-Length: 5\r\n\r\nhello";
+
+    // 缓存命中与否, Date域都在起始行之后, 并且是当前时间
+    struct iovec iov[16];
+    for (int i = 0; i < 3; ++i) {
+        if (i == 1) {
+            // 缓存不包含Date域, iovec中的Date域单独一段, 指向当前线程的快照
+            EXPECT_TRUE(doc.PrepareCache());
+            EXPECT_EQ(doc.IovecCount(), 4);
+            EXPECT_EQ(doc.SerializeToIovec(iov, 16), 4);
+            EXPECT_EQ(iov[1].iov_base, (void*)DateCache::Instance().Line());
+        }
+        std::string s = doc.SerializeAsString();
+        ASSERT_EQ(s.size(), start.size() + DateCache::c_line_size + rest.size());
+        EXPECT_EQ(s.substr(0, start.size()), start);
+        EXPECT_EQ(s.substr(start.size(), 6), "Date: ");
+        EXPECT_EQ(s.substr(start.size() + DateCache::c_line_size), rest);
+
+        size_t n = doc.SerializeToIovec(iov, 16);
+        EXPECT_EQ(n, doc.IovecCount());
+        EXPECT_EQ(JoinIovec(iov, n).size(), s.size());
+    }
+
+    // 没有其他域
+    Document empty(HTTP_RESPONSE);
+    empty.SetStatus(204, "No Content").SetDateField();
+    size_t n = empty.SerializeToIovec(iov, 16);
+    std::string s = JoinIovec(iov, n);
+    EXPECT_EQ(s.size(), 25 + DateCache::c_line_size + 2);
+    EXPECT_EQ(s.substr(s.size() - 8), " GMT\r\n\r\n");
+    EXPECT_EQ(empty.SerializeAsString().size(), s.size());
+
+    doc.SetDateField(false);
+    EXPECT_EQ(doc.IovecCount(), 3);
+    EXPECT_EQ(doc.SerializeAsString(), start + rest);
+}
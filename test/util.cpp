@@ -0,0 +1,49 @@
+#include <gtest/gtest.h>
+#include <rapidhttp/util.h>
+
+#include <string>
+
+using namespace std;
+using namespace rapidhttp;
+
+static std::string Decode(std::string const& s, bool plus_as_space = true) {
+    std::string out(s.size(), '\0');
+    out.resize(PercentDecode(s.data(), s.size(), &out[0], plus_as_space));
+
+    // 原地解码结果一致
+    std::string in_place = s;
+    in_place.resize(PercentDecodeInPlace(&in_place[0], in_place.size(), plus_as_space));
+    EXPECT_EQ(out, in_place);
+    return out;
+}
+
+TEST(util, percent_decode) {
+    EXPECT_EQ(Decode(""), "");
+    EXPECT_EQ(Decode("abc"), "abc");
+    EXPECT_EQ(Decode("a+b%20c"), "a b c");
+    EXPECT_EQ(Decode("a+b", false), "a+b");
+    EXPECT_EQ(Decode("%E4%BD%A0%e5%a5%bd"), "\xE4\xBD\xA0\xE5\xA5\xBD");
+    // 不合法的转义原样保留
+    EXPECT_EQ(Decode("%"), "%");
+    EXPECT_EQ(Decode("%4"), "%4");
+    EXPECT_EQ(Decode("%zz%41"), "%zzA");
+    EXPECT_EQ(Decode("100%"), "100%");
+
+    // 超过16字节的连续普通字符和跨块的转义
+    std::string plain(100, 'x');
+    EXPECT_EQ(Decode(plain), plain);
+    EXPECT_EQ(Decode(plain + "%41" + plain + "+"), plain + "A" + plain + " ");
+    EXPECT_EQ(Decode(std::string(15, 'y') + "%2F" + std::string(30, 'z')),
+              std::string(15, 'y') + "/" + std::string(30, 'z'));
+}
+
+TEST(util, parse_integer) {
+    uint64_t v = 0;
+    EXPECT_TRUE(ParseUInteger("0", 1, &v));
+    EXPECT_EQ(v, 0);
+    EXPECT_TRUE(ParseUInteger("18446744073709551615", 20, &v));
+    EXPECT_EQ(v, UINT64_MAX);
+    EXPECT_FALSE(ParseUInteger("18446744073709551616", 20, &v));
+    EXPECT_FALSE(ParseUInteger("12a", 3, &v));
+    EXPECT_FALSE(ParseUInteger("", 0, &v));
+}
@@ -1,5 +1,6 @@
 // #include <rapidhttp/document.h>
 #include <rapidhttp/doc.h>
+#include <rapidhttp/response_template.h>
 #include <unistd.h>
 
 #include <iostream>
@@ -54,7 +55,25 @@ void serialize() {
     cout << "serialize output:\n" << output << endl;
 }
 
+/// 固定格式的response: 编译期模板
+void serialize_template() {
+    // 1.定义模板: 固定部分在编译期拼好, 每两个固定片段之间是一个槽位
+    static constexpr auto c_health = rapidhttp::MakeResponseTemplate(
+        RAPIDHTTP_STATUS_LINE(200, "OK") "Server: rapidhttp\r\nContent-Length: ", "\r\n\r\n", "");
+
+    // 2.按顺序填入槽位的值: Content-Length和body
+    std::string body = "hello world!";
+    char buf[256];
+    if (!c_health.Serialize(buf, sizeof(buf), body.size(), body)) {
+        // 缓冲区不足
+        cout << "serialize error" << endl;
+        return;
+    }
+    cout << "serialize output:\n" << std::string(buf, c_health.ByteSize(body.size(), body)) << endl;
+}
+
 int main() {
     serialize();
+    serialize_template();
     return 0;
 }
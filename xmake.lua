@@ -2,7 +2,17 @@ set_xmakever("2.8.5")
 set_project("rapidhttp")
 set_config("plat", os.host())
 
-set_languages("c++11")
+option("cxx17")
+    set_default(false)
+    set_showmenu(true)
+    set_description("build with c++17, enables std::string_view as StringT")
+option_end()
+
+if has_config("cxx17") then
+    set_languages("c++17")
+else
+    set_languages("c++11")
+end
 set_warnings("all","error")
 
 add_rules("mode.debug", "mode.release", "mode.releasedbg")